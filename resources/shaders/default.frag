@@ -6,7 +6,7 @@ const uint LIGHT_POINT       = 0x1u;
 const uint LIGHT_DIRECTIONAL = 0x2u;
 const uint LIGHT_SPOT        = 0x4u;
 
-// condensed light data struct for shader
+// condensed light data struct for shader; std140 layout must match LightUniformData in lightbuffer.h
 struct LightData {
     uint type;
     vec3 color;
@@ -21,27 +21,32 @@ in vec3 positionWS;
 in vec3 normalWS;
 in vec2 uv;
 
+// material; comes from uniforms in default.vert and from per-instance attributes in default_instanced.vert
+flat in vec3 cAmbient;
+flat in vec3 cDiffuse;
+flat in vec3 cSpecular;
+flat in float shininess;
+flat in float blend;
+flat in float repeatU;
+flat in float repeatV;
+
 out vec4 fragColor;
 
 // ambient
 uniform float ka;
-uniform vec3 cAmbient;
 
 // diffuse
 uniform float kd;
-uniform vec3 cDiffuse;
-uniform int numLights;
-uniform LightData lights[MAX_LIGHTS];
+// lives in a uniform buffer (see LightBuffer) so it only needs to be uploaded when the lights change
+layout(std140) uniform Lights {
+    LightData lights[MAX_LIGHTS];
+    int numLights;
+};
 uniform bool usesTexture;
-uniform float blend;
-uniform float repeatU;
-uniform float repeatV;
 uniform sampler2D objTexture;
 
 // specular
 uniform float ks;
-uniform vec3 cSpecular;
-uniform float shininess;
 uniform vec3 cameraPosWS;
 
 //skybox
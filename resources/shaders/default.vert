@@ -9,15 +9,40 @@ out vec3 positionWS;
 out vec3 normalWS;
 out vec2 uv;
 
+// material, passed straight through to the fragment shader
+flat out vec3 cAmbient;
+flat out vec3 cDiffuse;
+flat out vec3 cSpecular;
+flat out float shininess;
+flat out float blend;
+flat out float repeatU;
+flat out float repeatV;
+
 uniform mat3 inverseTransposeModel;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 proj;
 
+uniform vec3 materialAmbient;
+uniform vec3 materialDiffuse;
+uniform vec3 materialSpecular;
+uniform float materialShininess;
+uniform float materialBlend;
+uniform float materialRepeatU;
+uniform float materialRepeatV;
+
 void main() {
     positionWS = (model * vec4(positionOS, 1.0)).xyz;
     normalWS = normalize(inverseTransposeModel * normalOS);
     uv = uvLayout;
 
+    cAmbient = materialAmbient;
+    cDiffuse = materialDiffuse;
+    cSpecular = materialSpecular;
+    shininess = materialShininess;
+    blend = materialBlend;
+    repeatU = materialRepeatU;
+    repeatV = materialRepeatV;
+
     gl_Position = proj * view * vec4(positionWS, 1.0);
 }
@@ -0,0 +1,45 @@
+#version 330 core
+
+layout (location = 0) in vec3 positionOS;
+layout (location = 1) in vec3 normalOS;
+layout (location = 2) in vec2 uvLayout;
+
+// per-instance attributes (see InstanceData in instancebatcher.h)
+layout (location = 3) in mat4 model;                 // takes locations 3-6
+layout (location = 7) in mat3 inverseTransposeModel; // takes locations 7-9
+layout (location = 10) in vec3 instanceAmbient;
+layout (location = 11) in vec3 instanceDiffuse;
+layout (location = 12) in vec3 instanceSpecular;
+layout (location = 13) in vec4 instanceMaterialParams; // shininess, blend, repeatU, repeatV
+
+// outs are passed to the fragment shader (default.frag)
+out vec3 positionWS;
+out vec3 normalWS;
+out vec2 uv;
+
+flat out vec3 cAmbient;
+flat out vec3 cDiffuse;
+flat out vec3 cSpecular;
+flat out float shininess;
+flat out float blend;
+flat out float repeatU;
+flat out float repeatV;
+
+uniform mat4 view;
+uniform mat4 proj;
+
+void main() {
+    positionWS = (model * vec4(positionOS, 1.0)).xyz;
+    normalWS = normalize(inverseTransposeModel * normalOS);
+    uv = uvLayout;
+
+    cAmbient = instanceAmbient;
+    cDiffuse = instanceDiffuse;
+    cSpecular = instanceSpecular;
+    shininess = instanceMaterialParams.x;
+    blend = instanceMaterialParams.y;
+    repeatU = instanceMaterialParams.z;
+    repeatV = instanceMaterialParams.w;
+
+    gl_Position = proj * view * vec4(positionWS, 1.0);
+}
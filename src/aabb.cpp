@@ -51,3 +51,11 @@ void AABB::translate(const glm::vec3& translation) {
     min += translation;
     max += translation;
 }
+
+AABB AABB::transformed(const glm::mat4& transform) const {
+    glm::mat3 linear = glm::mat3(transform);
+    glm::mat3 absLinear = glm::mat3(glm::abs(linear[0]), glm::abs(linear[1]), glm::abs(linear[2]));
+    glm::vec3 center = linear * ((min + max) * 0.5f) + glm::vec3(transform[3]);
+    glm::vec3 halfExtents = absLinear * ((max - min) * 0.5f);
+    return {center - halfExtents, center + halfExtents};
+}
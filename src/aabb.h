@@ -21,6 +21,11 @@ struct AABB {
 
     /// Translates the AABB by the given vector
     void translate(const glm::vec3& translation);
+
+    /// Returns the smallest AABB containing this box after the given affine transformation (Arvo's method: the
+    /// center is transformed, and the half extents by the absolute value of the linear part), without transforming
+    /// the 8 corners
+    AABB transformed(const glm::mat4& transform) const;
 };
 
 #pragma clang diagnostic pop
\ No newline at end of file
@@ -0,0 +1,94 @@
+// Times loading every image in a directory three ways: the old decode-then-copy loader (kept here as the reference),
+// decodeImageFile (which adopts stb_image's buffer), and loadImageFromFile with a warm texture blob cache.
+//
+// usage: image_load_bench [iterations] [directory]
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "utils/imagereader.h"
+#include "utils/stb_image.h"
+
+#define DEFAULT_ITERATIONS 10
+#define DEFAULT_DIRECTORY "scenefiles/moretextures"
+
+/// The loader before Image adopted stb_image's buffer: decode, then copy every pixel into a vector
+size_t loadByCopying(const std::string& file) {
+    int width, height;
+    unsigned char* imgData = stbi_load(file.c_str(), &width, &height, nullptr, 4);
+    if (!imgData) {
+        return 0;
+    }
+    std::vector<RGBA> data(width * height);
+    for (int i = 0; i < width * height; ++i) {
+        data[i] = {imgData[4 * i + 0], imgData[4 * i + 1], imgData[4 * i + 2], imgData[4 * i + 3]};
+    }
+    stbi_image_free(imgData);
+    // read a pixel so the copy can't be optimized away
+    return data.size() + data.back().a;
+}
+
+size_t checksum(const std::unique_ptr<Image>& image) {
+    if (!image) {
+        return 0;
+    }
+    return image->pixelCount() + image->data[image->pixelCount() - 1].a;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : DEFAULT_ITERATIONS;
+    std::string directory = argc > 2 ? argv[2] : DEFAULT_DIRECTORY;
+
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file()) {
+            files.push_back(entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) {
+        std::cerr << "No images in " << directory << std::endl;
+        return 1;
+    }
+
+    using clock = std::chrono::steady_clock;
+    std::cout << "iterations: " << iterations << std::endl;
+    std::cout << "file                                        copy (ms)   decode (ms) blob (ms)" << std::endl;
+    double totals[3] = {0.0, 0.0, 0.0};
+    size_t sum = 0;
+    for (const std::string& file : files) {
+        // make sure the blob exists before timing it
+        sum += checksum(loadImageFromFile(file));
+        // alternate the loaders so none of them gets a warmer page cache
+        double seconds[3] = {0.0, 0.0, 0.0};
+        for (int i = 0; i < iterations; i++) {
+            auto start = clock::now();
+            sum += loadByCopying(file);
+            seconds[0] += std::chrono::duration<double>(clock::now() - start).count();
+
+            start = clock::now();
+            sum += checksum(decodeImageFile(file));
+            seconds[1] += std::chrono::duration<double>(clock::now() - start).count();
+
+            start = clock::now();
+            sum += checksum(loadImageFromFile(file));
+            seconds[2] += std::chrono::duration<double>(clock::now() - start).count();
+        }
+        std::string name = std::filesystem::path(file).filename().string();
+        name.resize(std::max(name.size(), (size_t) 44), ' ');
+        std::cout << name;
+        for (int loader = 0; loader < 3; loader++) {
+            double ms = seconds[loader] * 1000.0 / iterations;
+            totals[loader] += ms;
+            std::cout << ms << "\t";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "total (ms per pass): copy " << totals[0] << ", decode " << totals[1] << ", blob " << totals[2]
+              << std::endl;
+    std::cout << "checksum: " << sum << std::endl;
+    return 0;
+}
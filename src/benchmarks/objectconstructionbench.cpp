@@ -0,0 +1,107 @@
+// Times constructing collision objects of each primitive (which computes their world-space AABB from the mesh), and
+// computing the AABB alone both with PrimitiveMesh::computeAABB and by transforming every vertex of the mesh (the old
+// implementation, kept here as the reference). Runs without a window or GL context, like headless_sim.
+//
+// usage: object_construction_bench [objects] [shapeParameter]
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "realtimescene.h"
+#include "objects/staticobject.h"
+#include "settings.h"
+
+#define DEFAULT_OBJECTS 10000
+#define DEFAULT_SHAPE_PARAMETER 20
+#define BENCH_SCENE "scenefiles/final/procedural_city.json"
+
+/// The AABB of every vertex of the mesh, transformed by the CTM
+AABB transformEveryVertex(const PrimitiveMesh& mesh, const glm::mat4& ctm) {
+    const std::vector<float>& vertices = mesh.indexedVertexData();
+    glm::vec3 first = glm::vec3(ctm * glm::vec4(vertices[0], vertices[1], vertices[2], 1));
+    AABB bounds{first, first};
+    for (size_t i = FLOATS_PER_VERTEX; i < vertices.size(); i += FLOATS_PER_VERTEX) {
+        glm::vec3 transformed = glm::vec3(ctm * glm::vec4(vertices[i], vertices[i + 1], vertices[i + 2], 1));
+        bounds.min = glm::min(bounds.min, transformed);
+        bounds.max = glm::max(bounds.max, transformed);
+    }
+    return bounds;
+}
+
+/// Rotated, scaled and translated differently for each object, like the city's buildings
+glm::mat4 objectCTM(int i) {
+    glm::mat4 ctm = glm::translate(glm::mat4(1.f), glm::vec3((float) (i % 100), 0.f, (float) (i / 100)));
+    ctm = glm::rotate(ctm, (float) i * 0.1f, glm::vec3(0.f, 1.f, 0.f));
+    return glm::scale(ctm, glm::vec3(1.f + (float) (i % 7), 2.f + (float) (i % 5), 1.f + (float) (i % 3)));
+}
+
+int main(int argc, char* argv[]) {
+    int numObjects = argc > 1 ? std::stoi(argv[1]) : DEFAULT_OBJECTS;
+    int shapeParameter = argc > 2 ? std::stoi(argv[2]) : DEFAULT_SHAPE_PARAMETER;
+    settings.shapeParameter1 = shapeParameter;
+    settings.shapeParameter2 = shapeParameter;
+    settings.sceneFilePath = BENCH_SCENE;
+
+    auto meshes = PrimitiveMesh::initMeshes(shapeParameter, shapeParameter);
+    auto scene = RealtimeScene::init(1, 1, settings.sceneFilePath, 0.05f, 100.f, meshes, std::make_shared<bool>(false));
+    if (!scene) {
+        return 1;
+    }
+    std::vector<glm::mat4> ctms;
+    ctms.reserve(numObjects);
+    for (int i = 0; i < numObjects; i++) {
+        ctms.push_back(objectCTM(i));
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto millisecondsSince = [](clock::time_point start) {
+        return std::chrono::duration<double>(clock::now() - start).count() * 1000.0;
+    };
+    std::cout << "objects: " << numObjects << ", shape parameter: " << shapeParameter << std::endl;
+    std::cout << "mesh      vertices  construct (objects/s)  computeAABB (ms)  every vertex (ms)" << std::endl;
+    std::vector<std::pair<std::string, PrimitiveType>> types = {
+            {"cube", PrimitiveType::PRIMITIVE_CUBE},
+            {"sphere", PrimitiveType::PRIMITIVE_SPHERE},
+            {"cylinder", PrimitiveType::PRIMITIVE_CYLINDER},
+            {"cone", PrimitiveType::PRIMITIVE_CONE},
+    };
+    float sum = 0.f;
+    for (const auto& [name, type] : types) {
+        const PrimitiveMesh& mesh = *meshes.at(type);
+
+        // the objects aren't added to the scene, so constructing them only creates their entity and computes their AABB
+        std::vector<std::unique_ptr<StaticObject>> objects;
+        objects.reserve(numObjects);
+        auto start = clock::now();
+        for (const glm::mat4& ctm : ctms) {
+            objects.push_back(std::make_unique<StaticObject>(
+                    RenderShapeData{ScenePrimitive{type, SceneMaterial{}}, ctm}, scene));
+        }
+        double constructMs = millisecondsSince(start);
+        sum += objects.back()->aabb().max.x;
+        objects.clear();
+
+        start = clock::now();
+        for (const glm::mat4& ctm : ctms) {
+            sum += mesh.computeAABB(ctm).max.x;
+        }
+        double computeMs = millisecondsSince(start);
+
+        start = clock::now();
+        for (const glm::mat4& ctm : ctms) {
+            sum += transformEveryVertex(mesh, ctm).max.x;
+        }
+        double everyVertexMs = millisecondsSince(start);
+
+        std::string paddedName = name;
+        paddedName.resize(10, ' ');
+        std::cout << paddedName << mesh.indexedVertexData().size() / FLOATS_PER_VERTEX << "\t    "
+                  << numObjects / (constructMs / 1000.0) << "\t\t   " << computeMs << "\t\t     " << everyVertexMs
+                  << std::endl;
+    }
+    std::cout << "checksum: " << sum << std::endl;
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Times regenerating each primitive's vertex data (PrimitiveMesh::setParams, which also welds it) for param1 = param2
+// from 3 to 200, tessellating on one thread and on every hardware thread.
+//
+// usage: tessellation_bench [iterations]
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "meshes/cubemesh.h"
+#include "meshes/spheremesh.h"
+#include "meshes/cylindermesh.h"
+#include "meshes/conemesh.h"
+#include "settings.h"
+
+#define DEFAULT_ITERATIONS 5
+
+/// Average milliseconds per setParams(param, param) call on the mesh
+double timeTessellation(PrimitiveMesh& mesh, int param, int iterations) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    for (int i = 0; i < iterations; i++) {
+        mesh.setParams(param, param);
+    }
+    return std::chrono::duration<double>(clock::now() - start).count() * 1000.0 / iterations;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : DEFAULT_ITERATIONS;
+    std::vector<int> params = {3, 5, 10, 20, 35, 50, 75, 100, 150, 200};
+    std::vector<std::pair<std::string, std::shared_ptr<PrimitiveMesh>>> meshes = {
+            {"cube", std::make_shared<CubeMesh>(1, 1)},
+            {"sphere", std::make_shared<SphereMesh>(1, 1)},
+            {"cylinder", std::make_shared<CylinderMesh>(1, 1)},
+            {"cone", std::make_shared<ConeMesh>(1, 1)},
+    };
+    unsigned int hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::cout << "iterations: " << iterations << ", hardware threads: " << hardwareThreads << std::endl;
+    std::cout << "mesh      param  vertices  1 thread (ms)  " << hardwareThreads << " threads (ms)" << std::endl;
+    size_t sum = 0;
+    for (const auto& [name, mesh] : meshes) {
+        for (int param : params) {
+            settings.tessellationThreads = 1;
+            double single = timeTessellation(*mesh, param, iterations);
+            settings.tessellationThreads = (int) hardwareThreads;
+            double parallel = timeTessellation(*mesh, param, iterations);
+            sum += mesh->vertexData().size();
+
+            std::string paddedName = name;
+            paddedName.resize(10, ' ');
+            std::cout << paddedName << param << "\t" << mesh->vertexCount() << "\t  " << single << "\t " << parallel
+                      << std::endl;
+        }
+    }
+    std::cout << "checksum: " << sum << std::endl;
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "camera.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <limits>
 
 Camera::Camera(int sceneWidth, int sceneHeight, const SceneCameraData& cameraData, float near, float far)
         : m_aspectRatio((float)sceneWidth / (float)sceneHeight), m_heightAngle(cameraData.heightAngle),
@@ -11,12 +12,14 @@ Camera::Camera(int sceneWidth, int sceneHeight, const SceneCameraData& cameraDat
     m_viewMatrix = computeViewMatrix();
     m_inverseViewMatrix = glm::inverse(m_viewMatrix);
     m_projectionMatrix = computeProjectionMatrix();
+    updateFrustum();
 }
 
 void Camera::translate(const glm::vec3& translation) {
     m_pos += translation;
     m_viewMatrix = computeViewMatrix();
     m_inverseViewMatrix = glm::inverse(m_viewMatrix);
+    updateFrustum();
 }
 
 void Camera::rotate(const glm::vec3& axisWS, float angleRad) {
@@ -25,6 +28,7 @@ void Camera::rotate(const glm::vec3& axisWS, float angleRad) {
     m_up = glm::normalize(rot * glm::vec4(m_up, 0.f));
     m_viewMatrix = computeViewMatrix();
     m_inverseViewMatrix = glm::inverse(m_viewMatrix);
+    updateFrustum();
 }
 
 void Camera::setCameraData(const SceneCameraData& cameraData) {
@@ -38,6 +42,7 @@ void Camera::setCameraData(const SceneCameraData& cameraData) {
     m_inverseViewMatrix = glm::inverse(m_viewMatrix);
 
     m_projectionMatrix = computeProjectionMatrix();
+    updateFrustum();
 }
 
 
@@ -46,6 +51,7 @@ void Camera::setSceneDimensions(int sceneWidth, int sceneHeight) {
     m_widthAngle = computeWidthAngle();
 
     m_projectionMatrix = computeProjectionMatrix();
+    updateFrustum();
 }
 
 void Camera::setNearAndFar(float near, float far) {
@@ -53,6 +59,7 @@ void Camera::setNearAndFar(float near, float far) {
     m_far = far;
 
     m_projectionMatrix = computeProjectionMatrix();
+    updateFrustum();
 }
 
 glm::mat4 Camera::computeViewMatrix() {
@@ -95,6 +102,10 @@ glm::mat4 Camera::computeProjectionMatrix() const {
     return opengl_correction_matrix * unhinge_matrix * scale_matrix;
 }
 
+void Camera::updateFrustum() {
+    m_frustum = Frustum::fromViewProjection(m_projectionMatrix * m_viewMatrix);
+}
+
 float Camera::computeWidthAngle() const {
     // using trig, you can figure out the relationship between aspect ratio, height angle, and width angle
     return 2 * glm::atan(m_aspectRatio * glm::tan(m_heightAngle / 2));
@@ -135,4 +146,17 @@ const glm::vec3& Camera::look() const {
 
 const glm::vec3& Camera::up() const {
     return m_up;
-}
\ No newline at end of file
+}
+
+const Frustum& Camera::frustum() const {
+    return m_frustum;
+}
+
+float Camera::projectedSize(const glm::vec3& center, float radius) const {
+    float distance = glm::length(center - m_pos);
+    if (distance <= radius) {
+        return std::numeric_limits<float>::infinity();
+    }
+    // the sphere's diameter over the height of the view plane at that distance
+    return radius / (distance * glm::tan(m_heightAngle / 2));
+}
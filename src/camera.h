@@ -4,6 +4,7 @@
 
 #include <glm/glm.hpp>
 #include "utils/scenedata.h"
+#include "frustum.h"
 
 // A class representing a virtual camera.
 
@@ -45,8 +46,16 @@ public:
 
     // Returns the up vector of the camera in world space.
     const glm::vec3& up() const;
+
+    // Returns the view frustum in world space (kept in sync with the view and projection matrices).
+    const Frustum& frustum() const;
+
+    // Returns roughly what fraction of the viewport's height a sphere with the given center and radius covers
+    // (infinite if the camera is inside it). Used to pick the level of detail to draw objects at.
+    float projectedSize(const glm::vec3& center, float radius) const;
 private:
     glm::mat4 computeViewMatrix();
+    void updateFrustum();
     glm::mat4 computeProjectionMatrix() const;
     float computeWidthAngle() const;
     // we can compute all of the values behind the above getters from the SceneCameraData.
@@ -54,6 +63,7 @@ private:
     glm::mat4 m_viewMatrix{};
     glm::mat4 m_inverseViewMatrix{};
     glm::mat4 m_projectionMatrix{};
+    Frustum m_frustum{};
     float m_aspectRatio;
     float m_widthAngle;
     float m_heightAngle;
@@ -0,0 +1,59 @@
+#include "chunkregistry.h"
+#include "objects/realtimeobject.h"
+
+void ChunkRegistry::activate(const GridCoord& cell) {
+    m_chunks.try_emplace(cell);
+}
+
+bool ChunkRegistry::isActive(const GridCoord& cell) const {
+    return m_chunks.contains(cell);
+}
+
+size_t ChunkRegistry::size() const {
+    return m_chunks.size();
+}
+
+size_t ChunkRegistry::objectCount(const GridCoord& cell) const {
+    return m_chunks.at(cell).objects.size();
+}
+
+const AABB& ChunkRegistry::bounds(const GridCoord& cell) const {
+    return m_chunks.at(cell).bounds;
+}
+
+void ChunkRegistry::addObject(const GridCoord& cell, const std::shared_ptr<RealtimeObject>& object) {
+    Chunk& chunk = m_chunks[cell];
+    const AABB& box = object->boundingBox();
+    if (chunk.objects.empty()) {
+        chunk.bounds = box;
+    } else {
+        chunk.bounds.min = glm::min(chunk.bounds.min, box.min);
+        chunk.bounds.max = glm::max(chunk.bounds.max, box.max);
+    }
+    chunk.objects.emplace_back(object);
+}
+
+void ChunkRegistry::addBuilding(const GridCoord& cell, const GridCoord& building) {
+    m_chunks[cell].buildings.push_back(building);
+    m_buildings.insert(building);
+}
+
+bool ChunkRegistry::hasBuilding(const GridCoord& building) const {
+    return m_buildings.contains(building);
+}
+
+void ChunkRegistry::unload(const GridCoord& cell) {
+    auto it = m_chunks.find(cell);
+    if (it == m_chunks.end()) {
+        return;
+    }
+    for (const auto& weakObject : it->second.objects) {
+        if (auto object = weakObject.lock()) {
+            object->queueFree();
+        }
+    }
+    for (const GridCoord& building : it->second.buildings) {
+        m_buildings.erase(building);
+    }
+    m_chunks.erase(it);
+}
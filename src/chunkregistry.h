@@ -0,0 +1,91 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "aabb.h"
+
+class RealtimeObject;
+
+struct pair_hash {
+    template <typename T1, typename T2>
+    std::size_t operator()(const std::pair<T1, T2>& pair) const {
+        std::size_t h1 = std::hash<T1>{}(pair.first);
+        std::size_t h2 = std::hash<T2>{}(pair.second);
+        return h1 ^ (h2 << 1); // Combine hashes using XOR and bit shifting
+    }
+};
+
+/// Keeps track of which city grid cells (chunks) are loaded, and which objects and buildings belong to each one,
+/// so a chunk can be unloaded without searching the scene's object list
+class ChunkRegistry {
+public:
+    typedef std::pair<int, int> GridCoord;
+
+    /// Marks the cell as loaded (does nothing if it already is)
+    void activate(const GridCoord& cell);
+    bool isActive(const GridCoord& cell) const;
+    /// Calls `f(cell)` for every loaded cell
+    template <typename F>
+    void forEachActive(F f) const {
+        for (const auto& [cell, chunk] : m_chunks) {
+            f(cell);
+        }
+    }
+    size_t size() const;
+    /// Calls `f(object)` for every object of the (loaded) cell that hasn't been destroyed
+    template <typename F>
+    void forEachObject(const GridCoord& cell, F f) const {
+        for (const auto& weakObject : m_chunks.at(cell).objects) {
+            if (std::shared_ptr<RealtimeObject> object = weakObject.lock()) {
+                f(*object);
+            }
+        }
+    }
+    /// Number of objects recorded for the (loaded) cell, including ones that have since been destroyed
+    size_t objectCount(const GridCoord& cell) const;
+    /// World-space bounds of every object recorded for the (loaded) cell; only meaningful if objectCount(cell) > 0
+    const AABB& bounds(const GridCoord& cell) const;
+
+    /// Records that `object` belongs to the (loaded) cell, so it's freed when the cell is unloaded, and grows the
+    /// cell's bounds to contain its bounding box
+    void addObject(const GridCoord& cell, const std::shared_ptr<RealtimeObject>& object);
+    /// Records that the building at `building` (see CityChunkPiece::buildingCoord) exists and belongs to the cell
+    void addBuilding(const GridCoord& cell, const GridCoord& building);
+    bool hasBuilding(const GridCoord& building) const;
+
+    /// Queues every object of the cell for freeing, forgets its buildings, and marks it as not loaded.
+    /// The scene drops freed objects in its next compaction pass, so this never touches the scene's object list
+    void unload(const GridCoord& cell);
+    /// Unloads every cell that `shouldUnload(cell)` returns true for
+    template <typename Predicate>
+    void unloadIf(Predicate shouldUnload) {
+        std::vector<GridCoord> toUnload;
+        for (const auto& [cell, chunk] : m_chunks) {
+            if (shouldUnload(cell)) {
+                toUnload.push_back(cell);
+            }
+        }
+        for (const GridCoord& cell : toUnload) {
+            unload(cell);
+        }
+    }
+
+private:
+    struct Chunk {
+        /// Weak so that the scene stays the only owner; objects freed some other way just expire
+        std::vector<std::weak_ptr<RealtimeObject>> objects;
+        std::vector<GridCoord> buildings;
+        /// Union of the objects' bounding boxes; objects never move, so it stays valid (if loose) as they're freed
+        AABB bounds{glm::vec3(0.f), glm::vec3(0.f)};
+    };
+
+    std::unordered_map<GridCoord, Chunk, pair_hash> m_chunks;
+    std::unordered_set<GridCoord, pair_hash> m_buildings;
+};
+
+#pragma clang diagnostic pop
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+#include "citychunkgenerator.h"
+
+namespace {
+    long long cellKey(int gridX, int gridZ) {
+        return ((long long) gridX << 32) | (unsigned int) gridZ;
+    }
+}
+
+CityChunkGenerator::CityChunkGenerator(std::shared_ptr<const PrimitiveMesh> cubeMesh, int rows, int cols, float spacing,
+                                       int numThreads)
+        : m_cubeMesh(std::move(cubeMesh)), m_rows(rows), m_cols(cols), m_spacing(spacing) {
+    for (int i = 0; i < numThreads; i++) {
+        m_workers.emplace_back(&CityChunkGenerator::workerLoop, this);
+    }
+}
+
+CityChunkGenerator::~CityChunkGenerator() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeWorkers.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+CityChunk CityChunkGenerator::generate(int gridX, int gridZ) const {
+    // deliberately default-seeded: every chunk gets the same sequence, so a chunk looks the same every time it's generated
+    std::default_random_engine generator;
+    std::uniform_real_distribution<float> heightDist(1.0f, 15.0f);
+    std::uniform_real_distribution<float> widthDist(1.0f, 3.0f);
+    std::uniform_real_distribution<float> depthDist(1.0f, 3.0f);
+
+    float baseX = gridX * m_cols * m_spacing;
+    float baseZ = gridZ * m_rows * m_spacing;
+
+    CityChunk chunk{gridX, gridZ, {}};
+    chunk.pieces.reserve(1 + m_rows * m_cols);
+
+    float floorWidth = m_cols * m_spacing;
+    float floorDepth = m_rows * m_spacing;
+    float floorHeight = 0.1f;
+
+    glm::vec3 floorPosition(
+        baseX + floorWidth / 2.0f - m_spacing / 2.0f,
+        -floorHeight / 2.0f - 3.f,
+        baseZ + floorDepth / 2.0f - m_spacing / 2.0f
+        );
+
+    glm::mat4 floorTransform = glm::translate(glm::mat4(1.0f), floorPosition) *
+                               glm::scale(glm::mat4(1.0f), glm::vec3(floorWidth, floorHeight, floorDepth));
+    chunk.pieces.push_back(CityChunkPiece{floorTransform, m_cubeMesh->computeAABB(floorTransform), CityMaterial::FLOOR,
+                                          glm::vec2(1.f), {0, 0}});
+
+    for (int i = 0; i < m_rows; ++i) {
+        for (int j = 0; j < m_cols; ++j) {
+            float height = heightDist(generator);
+            float width = widthDist(generator);
+            float depth = depthDist(generator);
+
+            glm::vec3 position(
+                baseX + i * m_spacing,
+                height / 2.0f - 3,
+                baseZ + j * m_spacing
+                );
+
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) *
+                                  glm::scale(glm::mat4(1.0f), glm::vec3(width, height, depth));
+            glm::vec2 uvRepeat = glm::vec2(((width + depth) / 2.f) / 5.f, height / 5.f);
+            chunk.pieces.push_back(CityChunkPiece{transform, m_cubeMesh->computeAABB(transform), CityMaterial::BUILDING,
+                                                  uvRepeat, {gridX * m_rows + i, gridZ * m_cols + j}});
+        }
+    }
+    return chunk;
+}
+
+void CityChunkGenerator::request(int gridX, int gridZ, float priority) {
+    long long key = cellKey(gridX, gridZ);
+    if (m_workers.empty()) {
+        // no workers: generate right away (still handed out through takeFinished, like the threaded path)
+        if (m_pending.insert(key).second) {
+            m_finished.push_back(generate(gridX, gridZ));
+        }
+        return;
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_pending.insert(key).second) {
+            auto queued = std::find_if(m_queue.begin(), m_queue.end(), [gridX, gridZ](const Request& r) {
+                return r.gridX == gridX && r.gridZ == gridZ;
+            });
+            if (queued != m_queue.end()) {
+                queued->priority = priority;
+            }
+            return;
+        }
+        m_queue.push_back(Request{gridX, gridZ, priority});
+    }
+    m_wakeWorkers.notify_one();
+}
+
+bool CityChunkGenerator::takeFinished(std::vector<CityChunk>& out) {
+    std::lock_guard lock(m_mutex);
+    if (m_finished.empty()) {
+        return false;
+    }
+    for (auto& chunk : m_finished) {
+        m_pending.erase(cellKey(chunk.gridX, chunk.gridZ));
+        out.push_back(std::move(chunk));
+    }
+    m_finished.clear();
+    return true;
+}
+
+bool CityChunkGenerator::isPending(int gridX, int gridZ) const {
+    std::lock_guard lock(m_mutex);
+    return m_pending.contains(cellKey(gridX, gridZ));
+}
+
+void CityChunkGenerator::workerLoop() {
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_wakeWorkers.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        if (m_stopping) {
+            return;
+        }
+        auto next = std::min_element(m_queue.begin(), m_queue.end(), [](const Request& a, const Request& b) {
+            return a.priority < b.priority;
+        });
+        Request request = *next;
+        m_queue.erase(next);
+
+        lock.unlock();
+        CityChunk chunk = generate(request.gridX, request.gridZ);
+        lock.lock();
+        m_finished.push_back(std::move(chunk));
+    }
+}
@@ -0,0 +1,92 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <glm/glm.hpp>
+#include "aabb.h"
+#include "meshes/primitivemesh.h"
+
+/// Which of the city's materials (see city_materials) a chunk piece uses
+enum class CityMaterial {
+    FLOOR,
+    BUILDING
+};
+
+/// One cube of a city chunk (the floor or a building), fully described so the main thread only has to create the object
+struct CityChunkPiece {
+    glm::mat4 ctm;
+    /// Precomputed world-space AABB of the cube with `ctm`, so the collision object doesn't have to compute it
+    AABB aabb;
+    CityMaterial material;
+    /// Texture repeat for this piece (buildings scale their texture with their size)
+    glm::vec2 uvRepeat;
+    /// Key of the building in ChunkRegistry::hasBuilding; unused for the floor
+    std::pair<int, int> buildingCoord;
+};
+
+/// Immutable description of everything in one city grid cell
+struct CityChunk {
+    int gridX;
+    int gridZ;
+    /// The floor comes first, followed by the buildings
+    std::vector<CityChunkPiece> pieces;
+};
+
+/// Generates city chunk descriptions on background threads. The scene requests chunks (ahead of where the player is
+/// heading), and takes finished ones to commit to the scene a few at a time
+class CityChunkGenerator {
+public:
+    /// `cubeMesh` must have its vertex data generated and must not change while the generator exists.
+    /// With `numThreads` == 0, requested chunks are generated immediately on the calling thread
+    CityChunkGenerator(std::shared_ptr<const PrimitiveMesh> cubeMesh, int rows, int cols, float spacing, int numThreads);
+    /// Stops and joins the worker threads (dropping any unfinished requests)
+    ~CityChunkGenerator();
+
+    CityChunkGenerator(const CityChunkGenerator&) = delete;
+    CityChunkGenerator& operator=(const CityChunkGenerator&) = delete;
+
+    /// Generates the chunk for a grid cell on the calling thread. The result only depends on the cell
+    CityChunk generate(int gridX, int gridZ) const;
+
+    /// Queues the cell for generation unless it's already queued or in progress. Lower `priority` values are generated first;
+    /// re-requesting a queued cell updates its priority
+    void request(int gridX, int gridZ, float priority);
+    /// Moves every finished chunk into `out` (appending); returns whether there were any
+    bool takeFinished(std::vector<CityChunk>& out);
+    /// Returns whether the cell has been requested but not yet taken with takeFinished
+    bool isPending(int gridX, int gridZ) const;
+
+private:
+    struct Request {
+        int gridX;
+        int gridZ;
+        float priority;
+    };
+
+    void workerLoop();
+
+    std::shared_ptr<const PrimitiveMesh> m_cubeMesh;
+    int m_rows;
+    int m_cols;
+    float m_spacing;
+
+    std::vector<std::thread> m_workers;
+    /// Guards everything below
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeWorkers;
+    bool m_stopping = false;
+    /// Queued requests, unordered (there are only ever a handful, so workers just scan for the lowest priority)
+    std::vector<Request> m_queue;
+    std::deque<CityChunk> m_finished;
+    /// Cells that are queued, being generated, or finished but not yet taken
+    std::unordered_set<long long> m_pending;
+};
+
+#pragma clang diagnostic pop
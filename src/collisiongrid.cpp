@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include "collisiongrid.h"
+#include "objects/collisionobject.h"
+
+CollisionGrid::CollisionGrid(float cellSize) : m_cellSize(cellSize) {}
+
+void CollisionGrid::insert(const std::shared_ptr<CollisionObject>& object) {
+    if (!object) {
+        return;
+    }
+    if (m_registrations.contains(object.get())) {
+        update(object.get());
+        return;
+    }
+    CellRange range = cellRange(object->aabb());
+    m_registrations[object.get()] = Registration{range, object};
+    addToCells(range, Entry{object.get(), object});
+}
+
+void CollisionGrid::update(const CollisionObject* object) {
+    auto it = m_registrations.find(object);
+    if (it == m_registrations.end()) {
+        return;
+    }
+    CellRange newRange = cellRange(object->aabb());
+    if (newRange == it->second.range) {
+        // most movement stays within the same cells, so this is the common case
+        return;
+    }
+    removeFromCells(it->second.range, object);
+    addToCells(newRange, Entry{object, it->second.weak});
+    it->second.range = newRange;
+}
+
+void CollisionGrid::remove(const CollisionObject* object) {
+    auto it = m_registrations.find(object);
+    if (it == m_registrations.end()) {
+        return;
+    }
+    removeFromCells(it->second.range, object);
+    m_registrations.erase(it);
+}
+
+void CollisionGrid::query(const AABB& box, std::vector<std::shared_ptr<CollisionObject>>& out) const {
+    size_t firstNew = out.size();
+    CellRange range = cellRange(box);
+    for (int x = range.min.x; x <= range.max.x; x++) {
+        for (int z = range.min.z; z <= range.max.z; z++) {
+            auto cell = m_cells.find({x, z});
+            if (cell == m_cells.end()) {
+                continue;
+            }
+            for (const auto& entry : cell->second) {
+                if (auto object = entry.weak.lock()) {
+                    out.push_back(std::move(object));
+                }
+            }
+        }
+    }
+    // objects spanning several cells show up once per cell
+    if (range.min != range.max) {
+        std::sort(out.begin() + (long) firstNew, out.end());
+        out.erase(std::unique(out.begin() + (long) firstNew, out.end()), out.end());
+    }
+}
+
+float CollisionGrid::cellSize() const {
+    return m_cellSize;
+}
+
+size_t CollisionGrid::size() const {
+    return m_registrations.size();
+}
+
+CollisionGrid::CellRange CollisionGrid::cellRange(const AABB& box) const {
+    return {
+        {(int) std::floor(box.min.x / m_cellSize), (int) std::floor(box.min.z / m_cellSize)},
+        {(int) std::floor(box.max.x / m_cellSize), (int) std::floor(box.max.z / m_cellSize)}
+    };
+}
+
+void CollisionGrid::addToCells(const CellRange& range, const Entry& entry) {
+    for (int x = range.min.x; x <= range.max.x; x++) {
+        for (int z = range.min.z; z <= range.max.z; z++) {
+            m_cells[{x, z}].push_back(entry);
+        }
+    }
+}
+
+void CollisionGrid::removeFromCells(const CellRange& range, const CollisionObject* object) {
+    for (int x = range.min.x; x <= range.max.x; x++) {
+        for (int z = range.min.z; z <= range.max.z; z++) {
+            auto cell = m_cells.find({x, z});
+            if (cell == m_cells.end()) {
+                continue;
+            }
+            auto& entries = cell->second;
+            auto entry = std::find_if(entries.begin(), entries.end(),
+                                      [object](const Entry& e) { return e.object == object; });
+            if (entry != entries.end()) {
+                // order within a cell doesn't matter, so swap-and-pop instead of shifting
+                *entry = std::move(entries.back());
+                entries.pop_back();
+            }
+            if (entries.empty()) {
+                // the city streams forever, so don't let empty cells pile up
+                m_cells.erase(cell);
+            }
+        }
+    }
+}
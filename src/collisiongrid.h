@@ -0,0 +1,70 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "aabb.h"
+
+class CollisionObject;
+
+/// Uniform-grid broadphase for CollisionObjects.
+/// The world is split into square cells on the xz plane (y is ignored since the city is basically flat), and every
+/// object is registered in each cell that its AABB overlaps. A query then only has to look at the cells overlapped by
+/// the query box instead of every collision object in the scene.
+class CollisionGrid {
+public:
+    explicit CollisionGrid(float cellSize);
+
+    /// Registers the object in every cell overlapped by its current AABB
+    void insert(const std::shared_ptr<CollisionObject>& object);
+    /// Re-buckets the object after its AABB has moved; cheap if it is still in the same cells
+    void update(const CollisionObject* object);
+    /// Removes the object from the grid (safe to call from the object's destructor)
+    void remove(const CollisionObject* object);
+
+    /// Appends every live object whose cells overlap `box` to `out`, with no duplicates.
+    /// This is only a broadphase; callers still need to test the actual AABBs
+    void query(const AABB& box, std::vector<std::shared_ptr<CollisionObject>>& out) const;
+
+    float cellSize() const;
+    /// Number of objects currently registered
+    size_t size() const;
+
+private:
+    struct CellCoord {
+        int x;
+        int z;
+        bool operator==(const CellCoord& other) const = default;
+    };
+    struct CellCoordHash {
+        std::size_t operator()(const CellCoord& c) const {
+            return std::hash<int>()(c.x) ^ (std::hash<int>()(c.z) << 1);
+        }
+    };
+    /// Inclusive range of cells covered by an AABB
+    struct CellRange {
+        CellCoord min;
+        CellCoord max;
+        bool operator==(const CellRange& other) const = default;
+    };
+    struct Entry {
+        const CollisionObject* object;
+        std::weak_ptr<CollisionObject> weak;
+    };
+    struct Registration {
+        CellRange range;
+        std::weak_ptr<CollisionObject> weak;
+    };
+
+    CellRange cellRange(const AABB& box) const;
+    void addToCells(const CellRange& range, const Entry& entry);
+    void removeFromCells(const CellRange& range, const CollisionObject* object);
+
+    float m_cellSize;
+    std::unordered_map<CellCoord, std::vector<Entry>, CellCoordHash> m_cells;
+    std::unordered_map<const CollisionObject*, Registration> m_registrations;
+};
+
+#pragma clang diagnostic pop
@@ -0,0 +1,175 @@
+#include "entitystore.h"
+
+EntityID EntityStore::create(RealtimeObject* owner, const glm::mat4& ctm) {
+    EntityID id;
+    if (!m_freeIDs.empty()) {
+        id = m_freeIDs.back();
+        m_freeIDs.pop_back();
+    } else {
+        id = (EntityID) m_slots.size();
+        m_slots.push_back(0);
+    }
+    m_slots[id] = (uint32_t) m_ids.size();
+
+    m_ctms.push_back(ctm);
+    // filled in by normalMatrix() on first read
+    m_normalMatrices.emplace_back(1.f);
+    m_bounds.push_back(AABB{glm::vec3(0.f), glm::vec3(0.f)});
+    m_velocities.emplace_back(0.f);
+    m_ranges.push_back(0.f);
+    m_flags.push_back(ENTITY_RENDER);
+    m_lodLevels.push_back(0);
+    m_systems.push_back(EntitySystem::NONE);
+    m_owners.push_back(owner);
+    m_ids.push_back(id);
+    return id;
+}
+
+void EntityStore::destroy(EntityID id) {
+    size_t index = slot(id);
+    size_t last = m_ids.size() - 1;
+    if (index != last) {
+        // move the last entity into the freed slot so the arrays stay dense
+        m_ctms[index] = m_ctms[last];
+        m_normalMatrices[index] = m_normalMatrices[last];
+        m_bounds[index] = m_bounds[last];
+        m_velocities[index] = m_velocities[last];
+        m_ranges[index] = m_ranges[last];
+        m_flags[index] = m_flags[last];
+        m_lodLevels[index] = m_lodLevels[last];
+        m_systems[index] = m_systems[last];
+        m_owners[index] = m_owners[last];
+        m_ids[index] = m_ids[last];
+        m_slots[m_ids[index]] = (uint32_t) index;
+    }
+    m_ctms.pop_back();
+    m_normalMatrices.pop_back();
+    m_bounds.pop_back();
+    m_velocities.pop_back();
+    m_ranges.pop_back();
+    m_flags.pop_back();
+    m_lodLevels.pop_back();
+    m_systems.pop_back();
+    m_owners.pop_back();
+    m_ids.pop_back();
+    m_freeIDs.push_back(id);
+}
+
+size_t EntityStore::size() const {
+    return m_ids.size();
+}
+
+size_t EntityStore::slot(EntityID id) const {
+    return m_slots[id];
+}
+
+const glm::mat4& EntityStore::ctm(EntityID id) const {
+    return m_ctms[slot(id)];
+}
+
+const glm::mat3& EntityStore::normalMatrix(EntityID id) {
+    size_t index = slot(id);
+    if (!(m_flags[index] & ENTITY_NORMAL_MATRIX_VALID)) {
+        m_normalMatrices[index] = glm::inverse(glm::transpose(glm::mat3(m_ctms[index])));
+        m_flags[index] |= ENTITY_NORMAL_MATRIX_VALID;
+    }
+    return m_normalMatrices[index];
+}
+
+AABB& EntityStore::bounds(EntityID id) {
+    return m_bounds[slot(id)];
+}
+
+const AABB& EntityStore::bounds(EntityID id) const {
+    return m_bounds[slot(id)];
+}
+
+glm::vec3& EntityStore::velocity(EntityID id) {
+    return m_velocities[slot(id)];
+}
+
+float& EntityStore::range(EntityID id) {
+    return m_ranges[slot(id)];
+}
+
+uint8_t& EntityStore::flags(EntityID id) {
+    return m_flags[slot(id)];
+}
+
+uint8_t EntityStore::flags(EntityID id) const {
+    return m_flags[slot(id)];
+}
+
+uint8_t& EntityStore::lodLevel(EntityID id) {
+    return m_lodLevels[slot(id)];
+}
+
+uint8_t EntityStore::lodLevel(EntityID id) const {
+    return m_lodLevels[slot(id)];
+}
+
+void EntityStore::setSystem(EntityID id, EntitySystem system) {
+    m_systems[slot(id)] = system;
+}
+
+void EntityStore::translate(EntityID id, const glm::vec3& translation) {
+    translateAt(slot(id), translation);
+}
+
+void EntityStore::translateAt(size_t index, const glm::vec3& translation) {
+    // a translation only changes the last column, so there's no need for a matrix multiply
+    m_ctms[index][3] += glm::vec4(translation, 0.f);
+    if (m_flags[index] & ENTITY_BOUNDS_VALID) {
+        m_bounds[index].translate(translation);
+    }
+}
+
+RealtimeObject* EntityStore::ownerAt(size_t index) const {
+    return m_owners[index];
+}
+
+uint8_t EntityStore::flagsAt(size_t index) const {
+    return m_flags[index];
+}
+
+const AABB& EntityStore::boundsAt(size_t index) const {
+    return m_bounds[index];
+}
+
+void EntityStore::followCamera(const glm::vec3& cameraPos) {
+    for (size_t i = 0; i < m_ids.size(); i++) {
+        if (m_systems[i] == EntitySystem::FOLLOW_CAMERA) {
+            translateAt(i, cameraPos - glm::vec3(m_ctms[i][3]));
+        }
+    }
+}
+
+void EntityStore::integrateLinearMotion(float elapsedSeconds) {
+    for (size_t i = 0; i < m_ids.size(); i++) {
+        if (m_systems[i] != EntitySystem::LINEAR_MOTION) {
+            continue;
+        }
+        glm::vec3 translation = m_velocities[i] * elapsedSeconds;
+        translateAt(i, translation);
+        m_ranges[i] -= glm::length(translation);
+        if (m_ranges[i] <= 0.f) {
+            m_flags[i] |= ENTITY_QUEUED_FREE;
+        }
+    }
+}
+
+void EntityStore::seekTarget(const glm::vec3& target, float speed, float despawnDistance) {
+    for (size_t i = 0; i < m_ids.size(); i++) {
+        if (m_systems[i] != EntitySystem::SEEK_TARGET) {
+            continue;
+        }
+        // only steer horizontally; the y component of the velocity is left to the object's own physics
+        glm::vec3 toTarget = glm::vec3(target.x - m_ctms[i][3].x, 0.f, target.z - m_ctms[i][3].z);
+        if (glm::length(toTarget) > despawnDistance) {
+            m_flags[i] |= ENTITY_QUEUED_FREE;
+        }
+        glm::vec3 horizontalVelocity = glm::normalize(toTarget) * speed;
+        m_velocities[i].x = horizontalVelocity.x;
+        m_velocities[i].z = horizontalVelocity.z;
+    }
+}
@@ -0,0 +1,107 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "aabb.h"
+
+class RealtimeObject;
+
+/// Stable handle to an entity in an EntityStore; stays valid until the entity is destroyed
+typedef uint32_t EntityID;
+
+/// Bits of EntityStore::flags
+enum EntityFlag : uint8_t {
+    ENTITY_RENDER = 1 << 0,
+    ENTITY_QUEUED_FREE = 1 << 1,
+    /// bounds() holds the entity's current world-space AABB
+    ENTITY_BOUNDS_VALID = 1 << 2,
+    /// The owner isn't ticked until it's woken (see RealtimeObject::sleep)
+    ENTITY_ASLEEP = 1 << 3,
+    /// The owner is in the scene's tick list
+    ENTITY_IN_TICK_LIST = 1 << 4,
+    /// normalMatrix() has been computed from the CTM's linear part
+    ENTITY_NORMAL_MATRIX_VALID = 1 << 5
+};
+
+/// Which of EntityStore's batched passes (if any) updates the entity
+enum class EntitySystem : uint8_t {
+    NONE,
+    /// Moves to the camera every tick (the skybox)
+    FOLLOW_CAMERA,
+    /// Moves by velocity() every tick, and is freed after traveling range() units. Only for objects without collision,
+    /// since the pass doesn't update the collision grid
+    LINEAR_MOTION,
+    /// Sets the horizontal part of velocity() to head towards the target, and is freed when too far from it (enemies);
+    /// the object's own tick still applies the velocity
+    SEEK_TARGET
+};
+
+/// Structure-of-arrays storage for the per-object state that gets touched every tick and every frame: transforms,
+/// bounds, velocities and flags. Every RealtimeObject owns one entity; the arrays are kept dense (destroying an entity
+/// moves the last one into its slot), so passes over every entity are linear walks over contiguous memory
+class EntityStore {
+public:
+    /// Adds an entity owned by `owner`, with the given CTM and the ENTITY_RENDER flag set
+    EntityID create(RealtimeObject* owner, const glm::mat4& ctm);
+    void destroy(EntityID id);
+    /// Number of live entities
+    size_t size() const;
+
+    // per-entity components
+    /// Only translate() and the batched systems move the CTM after creation, so its linear part never changes
+    const glm::mat4& ctm(EntityID id) const;
+    /// Inverse transpose of the CTM's linear part. Computed on first read rather than in create(), since most entities
+    /// (culled buildings, projectiles that never reach the screen, everything in headless_sim) are never drawn, and
+    /// translations don't change it
+    const glm::mat3& normalMatrix(EntityID id);
+    /// Only meaningful if the ENTITY_BOUNDS_VALID flag is set
+    AABB& bounds(EntityID id);
+    const AABB& bounds(EntityID id) const;
+    glm::vec3& velocity(EntityID id);
+    /// Remaining distance the entity may travel (see EntitySystem::LINEAR_MOTION)
+    float& range(EntityID id);
+    uint8_t& flags(EntityID id);
+    uint8_t flags(EntityID id) const;
+    /// Level of detail the entity was last drawn at (see PrimitiveMesh::lod)
+    uint8_t& lodLevel(EntityID id);
+    uint8_t lodLevel(EntityID id) const;
+    void setSystem(EntityID id, EntitySystem system);
+
+    /// Translates the CTM (the normal matrix doesn't change) and the bounds, if they're valid
+    void translate(EntityID id, const glm::vec3& translation);
+
+    // access by dense index in [0, size()), for passes over every entity; indices change when entities are destroyed
+    RealtimeObject* ownerAt(size_t index) const;
+    uint8_t flagsAt(size_t index) const;
+    const AABB& boundsAt(size_t index) const;
+
+    // batched systems; references returned above may be invalidated by create, but not by these
+    void followCamera(const glm::vec3& cameraPos);
+    void integrateLinearMotion(float elapsedSeconds);
+    void seekTarget(const glm::vec3& target, float speed, float despawnDistance);
+
+private:
+    size_t slot(EntityID id) const;
+    void translateAt(size_t index, const glm::vec3& translation);
+
+    // one array per component, indexed by slot
+    std::vector<glm::mat4> m_ctms;
+    std::vector<glm::mat3> m_normalMatrices;
+    std::vector<AABB> m_bounds;
+    std::vector<glm::vec3> m_velocities;
+    std::vector<float> m_ranges;
+    std::vector<uint8_t> m_flags;
+    std::vector<uint8_t> m_lodLevels;
+    std::vector<EntitySystem> m_systems;
+    std::vector<RealtimeObject*> m_owners;
+    std::vector<EntityID> m_ids;
+
+    /// slot of each entity, indexed by EntityID
+    std::vector<uint32_t> m_slots;
+    std::vector<EntityID> m_freeIDs;
+};
+
+#pragma clang diagnostic pop
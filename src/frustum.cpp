@@ -0,0 +1,36 @@
+#include "frustum.h"
+
+Frustum Frustum::fromViewProjection(const glm::mat4& viewProj) {
+    // glm is column-major, so row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+    auto row = [&viewProj](int i) {
+        return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+    };
+    glm::vec4 x = row(0);
+    glm::vec4 y = row(1);
+    glm::vec4 z = row(2);
+    glm::vec4 w = row(3);
+
+    Frustum frustum{};
+    // a point is inside the clip volume iff -w <= x, y, z <= w
+    frustum.planes = {w + x, w - x, w + y, w - y, w + z, w - z};
+    for (auto& plane : frustum.planes) {
+        // normalize so the plane equation gives actual distances (not needed for the test, but nice for debugging)
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+bool Frustum::intersects(const AABB& box) const {
+    for (const auto& plane : planes) {
+        // the corner of the box furthest along the plane normal; if even that is outside, the whole box is
+        glm::vec3 furthest = glm::vec3(
+                plane.x >= 0.f ? box.max.x : box.min.x,
+                plane.y >= 0.f ? box.max.y : box.min.y,
+                plane.z >= 0.f ? box.max.z : box.min.z
+        );
+        if (glm::dot(glm::vec3(plane), furthest) + plane.w < 0.f) {
+            return false;
+        }
+    }
+    return true;
+}
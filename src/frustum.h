@@ -0,0 +1,23 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <array>
+#include <glm/glm.hpp>
+#include "aabb.h"
+
+/// View frustum in world space, stored as 6 planes whose normals point into the frustum
+struct Frustum {
+    /// Each plane is (a, b, c, d) such that a*x + b*y + c*z + d >= 0 for points on the inside
+    /// Order: left, right, bottom, top, near, far
+    std::array<glm::vec4, 6> planes;
+
+    /// Extracts the planes from a combined projection * view matrix (Gribb-Hartmann), assuming OpenGL clip space
+    static Frustum fromViewProjection(const glm::mat4& viewProj);
+
+    /// Returns false only if the box is definitely outside the frustum (conservative: boxes near the corners of the
+    /// frustum may be reported as intersecting even if they aren't)
+    bool intersects(const AABB& box) const;
+};
+
+#pragma clang diagnostic pop
@@ -0,0 +1,94 @@
+// Runs the game simulation without a window or GL context and reports how long the ticks took.
+// Used to profile gameplay on machines without a GPU; the input is scripted so runs are comparable.
+//
+// usage: headless_sim [numTicks] [sceneFilePath]
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <GLFW/glfw3.h>
+#include "realtimescene.h"
+#include "settings.h"
+#include "utils/imagecache.h"
+
+// same as the game's fixed physics rate in mainwindow.cpp
+#define PHYSICS_RATE 60
+#define DEFAULT_NUM_TICKS 3600
+#define HEADLESS_WIDTH 1280
+#define HEADLESS_HEIGHT 720
+#define HEADLESS_SEED 1230
+
+/// Feeds the scene the same input every run: walk forward while slowly turning, jumping and shooting periodically
+void scriptInput(RealtimeScene& scene, int tick) {
+    if (tick == 0) {
+        scene.keyPressEvent(GLFW_KEY_W);
+    }
+    // only ever turn horizontally; looking straight up/down makes the camera's up and look vectors parallel
+    scene.mouseMoveEvent(tick * 2.0, 0.0);
+    if (tick % 30 == 0) {
+        scene.mousePressEvent(GLFW_MOUSE_BUTTON_LEFT);
+    } else if (tick % 30 == 1) {
+        scene.mouseReleaseEvent(GLFW_MOUSE_BUTTON_LEFT);
+    }
+    if (tick % 90 == 0) {
+        scene.keyPressEvent(GLFW_KEY_SPACE);
+    } else if (tick % 90 == 1) {
+        scene.keyReleaseEvent(GLFW_KEY_SPACE);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int numTicks = argc > 1 ? std::stoi(argv[1]) : DEFAULT_NUM_TICKS;
+    // same settings as MainWindow::initialize
+    settings.farPlane = 100.f;
+    settings.nearPlane = 0.05f;
+    settings.shapeParameter1 = 20;
+    settings.shapeParameter2 = 20;
+    settings.sceneFilePath = argc > 2 ? argv[2] : "scenefiles/final/procedural_city.json";
+
+    auto meshes = PrimitiveMesh::initMeshes(settings.shapeParameter1, settings.shapeParameter2);
+    auto scene = RealtimeScene::init(HEADLESS_WIDTH, HEADLESS_HEIGHT, settings.sceneFilePath,
+                                     settings.nearPlane, settings.farPlane, meshes, std::make_shared<bool>(false));
+    if (!scene) {
+        return 1;
+    }
+    scene->seedRandom(HEADLESS_SEED);
+
+    using clock = std::chrono::steady_clock;
+    RealtimeScene::TickStats totals;
+    double totalSeconds = 0.0;
+    double tickSeconds = 1.0 / (double) PHYSICS_RATE;
+    for (int tick = 0; tick < numTicks; tick++) {
+        scriptInput(*scene, tick);
+        auto start = clock::now();
+        scene->tick(tickSeconds);
+        totalSeconds += std::chrono::duration<double>(clock::now() - start).count();
+
+        const RealtimeScene::TickStats& stats = scene->lastTickStats();
+        totals.objectTick += stats.objectTick;
+        totals.particles += stats.particles;
+        totals.spawn += stats.spawn;
+        totals.compaction += stats.compaction;
+        totals.dynamicCity += stats.dynamicCity;
+        totals.objectsTicked += stats.objectsTicked;
+    }
+
+    auto perTickMs = [numTicks](double seconds) {
+        return seconds * 1000.0 / numTicks;
+    };
+    std::cout << "ticks:              " << numTicks << " (" << scene->simTime() << "s simulated)" << std::endl;
+    std::cout << "ticks/sec:          " << numTicks / totalSeconds << std::endl;
+    std::cout << "ms/tick:            " << perTickMs(totalSeconds) << std::endl;
+    std::cout << "  object tick:      " << perTickMs(totals.objectTick) << std::endl;
+    std::cout << "  particles:        " << perTickMs(totals.particles) << std::endl;
+    std::cout << "  spawn:            " << perTickMs(totals.spawn) << std::endl;
+    std::cout << "  compaction:       " << perTickMs(totals.compaction) << std::endl;
+    std::cout << "  dynamic city:     " << perTickMs(totals.dynamicCity) << std::endl;
+    std::cout << "objects ticked:     " << (double) totals.objectsTicked / numTicks << "/tick" << std::endl;
+    std::cout << "objects at end:     " << scene->m_objects.size() << std::endl;
+    ImageCache::Stats imageStats = ImageCache::global().stats();
+    std::cout << "image cache:        " << imageStats.hits << " hits, " << imageStats.misses << " misses, "
+              << imageStats.evictions << " evictions, " << imageStats.entries << " images ("
+              << imageStats.bytes / 1024 << " KiB)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <cstddef>
+#include "instancebatcher.h"
+#include "objects/realtimeobject.h"
+#include "utils/helpers.h"
+
+void InstanceBatcher::begin() {
+    for (auto& [_, group] : m_groups) {
+        group.instances.clear();
+        group.texture = nullptr;
+    }
+}
+
+void InstanceBatcher::add(RealtimeObject& object) {
+    GLTexture* texture = object.usesTexture() ? object.texture() : nullptr;
+    Group& group = m_groups[GroupKey{&object.renderMesh(), texture}];
+
+    const SceneMaterial& material = object.material();
+    group.instances.push_back(InstanceData{
+        object.CTM(),
+        object.inverseTransposeCTM(),
+        material.cAmbient.xyz(),
+        material.cDiffuse.xyz(),
+        material.cSpecular.xyz(),
+        glm::vec4(material.shininess, material.blend, object.uvRepeat().x, object.uvRepeat().y)
+    });
+    group.isSkybox = object.type() == PrimitiveType::PRIMITIVE_SKYBOX;
+    group.texture = texture;
+}
+
+std::vector<InstanceData>& InstanceBatcher::instancesFor(const PrimitiveMesh* mesh) {
+    return m_groups[GroupKey{mesh, nullptr}].instances;
+}
+
+void InstanceBatcher::draw(const UniformLocations& uniforms) {
+    if (!m_glAllocated) {
+        glGenBuffers(1, &m_instanceVBO);
+        m_glAllocated = true;
+    }
+    glActiveTexture(GL_TEXTURE0);
+    for (auto& [key, group] : m_groups) {
+        if (group.instances.empty()) {
+            continue;
+        }
+        bool usesTexture = group.texture != nullptr;
+        if (usesTexture) {
+            glBindTexture(GL_TEXTURE_2D, group.texture->id());
+        }
+        helpers::passUniformInt(uniforms[Uniform::USES_TEXTURE], usesTexture ? 1 : 0);
+        helpers::passUniformInt(uniforms[Uniform::IS_SKYBOX], group.isSkybox ? 1 : 0);
+
+        auto instanceBytes = (GLsizeiptr) (group.instances.size() * sizeof(InstanceData));
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+        // orphan the previous storage so we don't have to wait on the last group's draw before writing
+        glBufferData(GL_ARRAY_BUFFER, instanceBytes, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instanceBytes, group.instances.data());
+
+        glBindVertexArray(vaoFor(key.mesh));
+        key.mesh->drawInstanced((GLsizei) group.instances.size());
+        glBindVertexArray(0);
+        if (usesTexture) {
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBatcher::finish() {
+    for (auto& [_, vao] : m_vaos) {
+        glDeleteVertexArrays(1, &vao);
+    }
+    m_vaos.clear();
+    if (m_glAllocated) {
+        glDeleteBuffers(1, &m_instanceVBO);
+        m_glAllocated = false;
+    }
+}
+
+GLuint InstanceBatcher::vaoFor(const PrimitiveMesh* mesh) {
+    auto it = m_vaos.find(mesh);
+    if (it != m_vaos.end()) {
+        return it->second;
+    }
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    // per-vertex attributes come from the mesh's own vbo
+    mesh->bindVertexAttributes();
+
+    // per-instance attributes
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    auto stride = (GLsizei) sizeof(InstanceData);
+    // a mat4 attribute takes up 4 consecutive locations, one per column
+    for (GLuint col = 0; col < 4; col++) {
+        GLuint loc = 3 + col;
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, stride,
+                              (void*) (offsetof(InstanceData, model) + col * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+    // same for the mat3, which takes up 3 locations
+    for (GLuint col = 0; col < 3; col++) {
+        GLuint loc = 7 + col;
+        glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, stride,
+                              (void*) (offsetof(InstanceData, inverseTransposeModel) + col * sizeof(glm::vec3)));
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+    glVertexAttribPointer(10, 3, GL_FLOAT, GL_FALSE, stride, (void*) offsetof(InstanceData, cAmbient));
+    glVertexAttribPointer(11, 3, GL_FLOAT, GL_FALSE, stride, (void*) offsetof(InstanceData, cDiffuse));
+    glVertexAttribPointer(12, 3, GL_FLOAT, GL_FALSE, stride, (void*) offsetof(InstanceData, cSpecular));
+    glVertexAttribPointer(13, 4, GL_FLOAT, GL_FALSE, stride, (void*) offsetof(InstanceData, materialParams));
+    for (GLuint loc = 10; loc <= 13; loc++) {
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_vaos[mesh] = vao;
+    return vao;
+}
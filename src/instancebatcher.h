@@ -0,0 +1,66 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <map>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "meshes/primitivemesh.h"
+#include "utils/uniformlocations.h"
+
+class RealtimeObject;
+class GLTexture;
+
+/// Per-instance data uploaded to the instance vbo; must match the attributes in default_instanced.vert
+struct InstanceData {
+    glm::mat4 model;
+    glm::mat3 inverseTransposeModel;
+    glm::vec3 cAmbient;
+    glm::vec3 cDiffuse;
+    glm::vec3 cSpecular;
+    /// shininess, blend, repeatU, repeatV
+    glm::vec4 materialParams;
+};
+static_assert(sizeof(InstanceData) == (16 + 9 + 3 * 3 + 4) * sizeof(float), "InstanceData must be tightly packed");
+
+/// Groups objects that share a mesh and a texture so each group can be drawn with a single instanced draw call
+class InstanceBatcher {
+public:
+    /// Clears all groups from the last frame (keeps their allocations around for reuse)
+    void begin();
+    /// Adds the object to the group for its (mesh, texture) pair, using the mesh for the object's level of detail
+    void add(RealtimeObject& object);
+    /// Returns the instance list of the untextured group for `mesh`, for callers that build their own InstanceData
+    /// (e.g. ParticleSystem); anything appended to it is drawn like any other instance
+    std::vector<InstanceData>& instancesFor(const PrimitiveMesh* mesh);
+    /// Uploads the instance data and draws every group with the (already bound) instanced shader program
+    /// whose uniform locations are `uniforms`
+    void draw(const UniformLocations& uniforms);
+    /// Deletes the instance vbo and the per-mesh vaos
+    void finish();
+
+private:
+    struct GroupKey {
+        const PrimitiveMesh* mesh;
+        const GLTexture* texture;
+        auto operator<=>(const GroupKey& other) const = default;
+    };
+    struct Group {
+        std::vector<InstanceData> instances;
+        /// Bound for the whole group; the same pointer as the key's, but non-const so it can be uploaded on first draw
+        GLTexture* texture = nullptr;
+        bool isSkybox = false;
+    };
+
+    /// Returns the instanced vao for the mesh, creating it on first use
+    GLuint vaoFor(const PrimitiveMesh* mesh);
+
+    std::map<GroupKey, Group> m_groups;
+    /// One vao per mesh, combining the mesh's vbo (per-vertex) with m_instanceVBO (per-instance)
+    std::map<const PrimitiveMesh*, GLuint> m_vaos;
+    GLuint m_instanceVBO = 0;
+    bool m_glAllocated = false;
+};
+
+#pragma clang diagnostic pop
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include "lightbuffer.h"
+
+const unsigned int SHADER_LIGHT_POINT       = 0x1u;
+const unsigned int SHADER_LIGHT_DIRECTIONAL = 0x2u;
+const unsigned int SHADER_LIGHT_SPOT        = 0x4u;
+
+void LightBuffer::bindBlock(GLuint program) {
+    GLuint blockIndex = glGetUniformBlockIndex(program, "Lights");
+    if (blockIndex == GL_INVALID_INDEX) {
+        std::cerr << "Could not find uniform block Lights in shader program" << std::endl;
+        return;
+    }
+    glUniformBlockBinding(program, blockIndex, LIGHTS_UBO_BINDING);
+}
+
+void LightBuffer::update(const std::vector<SceneLightData>& lights) {
+    size_t numLights = std::min(lights.size(), (size_t) MAX_LIGHTS);
+    m_staged.numLights = (GLint) numLights;
+    for (size_t i = 0; i < numLights; i++) {
+        const SceneLightData& light = lights[i];
+        LightUniformData& packed = m_staged.lights[i];
+        packed.type = lightTypeToUniform(light.type);
+        packed.color = light.color.xyz();
+        packed.pos = light.pos.xyz();
+        packed.dir = light.dir.xyz();
+        packed.function = light.function;
+        packed.angle = light.angle;
+        packed.penumbra = light.penumbra;
+    }
+
+    if (!m_glAllocated) {
+        glGenBuffers(1, &m_ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBlockData), &m_staged, GL_DYNAMIC_DRAW);
+        m_uploaded = m_staged;
+        m_glAllocated = true;
+    } else if (std::memcmp(&m_staged, &m_uploaded, sizeof(LightBlockData)) != 0) {
+        // most frames nothing changes; when something does (e.g. the flashlight following the camera) it's one small upload
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightBlockData), &m_staged);
+        m_uploaded = m_staged;
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHTS_UBO_BINDING, m_ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void LightBuffer::finish() {
+    if (m_glAllocated) {
+        glDeleteBuffers(1, &m_ubo);
+        m_glAllocated = false;
+    }
+}
+
+GLuint LightBuffer::lightTypeToUniform(LightType type) {
+    switch (type) {
+    case LightType::LIGHT_POINT:
+        return SHADER_LIGHT_POINT;
+    case LightType::LIGHT_DIRECTIONAL:
+        return SHADER_LIGHT_DIRECTIONAL;
+    case LightType::LIGHT_SPOT:
+        return SHADER_LIGHT_SPOT;
+    default:
+        throw std::runtime_error("Invalid light type");
+    }
+}
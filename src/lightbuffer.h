@@ -0,0 +1,64 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "utils/scenedata.h"
+
+// must match MAX_LIGHTS in default.frag
+#define MAX_LIGHTS 16
+// uniform buffer binding point of the Lights block in default.frag
+#define LIGHTS_UBO_BINDING 0
+
+/// One element of the Lights block in default.frag, laid out by the std140 rules
+/// (vec3s are aligned to 16 bytes, and a following scalar can fill the 4th component)
+struct LightUniformData {
+    GLuint type;
+    float pad0[3];
+    glm::vec3 color;
+    float pad1;
+    glm::vec3 pos;
+    float pad2;
+    glm::vec3 dir;
+    float pad3;
+    glm::vec3 function;
+    float angle;
+    float penumbra;
+    float pad4[3];
+};
+static_assert(sizeof(LightUniformData) == 96, "LightUniformData must match the std140 layout of LightData");
+
+/// The whole Lights block in default.frag
+struct LightBlockData {
+    LightUniformData lights[MAX_LIGHTS];
+    GLint numLights;
+    GLint pad[3];
+};
+static_assert(sizeof(LightBlockData) == 96 * MAX_LIGHTS + 16, "LightBlockData must match the std140 layout of Lights");
+
+/// Uniform buffer holding the scene's lights; the data is only re-uploaded when the lights actually change
+class LightBuffer {
+public:
+    /// Binds the Lights block of `program` to LIGHTS_UBO_BINDING
+    static void bindBlock(GLuint program);
+    /// Packs the lights into the std140 layout and uploads them if they differ from the last upload.
+    /// Also (re)binds the buffer to LIGHTS_UBO_BINDING
+    void update(const std::vector<SceneLightData>& lights);
+    /// Deletes the uniform buffer
+    void finish();
+
+    /// convert enum class LightType to the corresponding uniform value
+    static GLuint lightTypeToUniform(LightType type);
+
+private:
+    /// The block as it was last uploaded, compared against m_staged to skip redundant uploads
+    LightBlockData m_uploaded{};
+    /// Repacked every update; a member rather than a local so the padding stays zeroed and memcmp is meaningful
+    LightBlockData m_staged{};
+    GLuint m_ubo = 0;
+    bool m_glAllocated = false;
+};
+
+#pragma clang diagnostic pop
@@ -0,0 +1,28 @@
+#include "city_materials.h"
+
+namespace city_materials {
+
+    SceneMaterial floorMaterial = SceneMaterial{
+        SceneColor(0.1f, 0.1f, 0.1f, 1.0f), //ambient
+        SceneColor(0.2f, 0.2f, 0.2f, 1.0f), //diffuse
+        SceneColor(0.2f, 0.2f, 0.2f, 1.0f), //specular
+        5.f, //shininess
+        SceneColor{glm::vec4(0.f)},
+        SceneColor{glm::vec4(0.f)},
+        0.f, //index of refraction
+        SceneFileMap{true, std::string("scenefiles/moretextures/doomfloor.jpg"), 1.f, 1.f},
+        0.5f //blend
+    };
+
+    SceneMaterial buildingMaterial = SceneMaterial{
+        SceneColor(0.1f, 0.1f, 0.1f, 1.0f), //ambient
+        SceneColor(0.3f, 0.3f, 0.3f, 1.0f), //diffuse
+        SceneColor(0.5f, 0.5f, 0.5f, 1.0f), //specular
+        10.f, //shininess
+        SceneColor{glm::vec4(0.f)},
+        SceneColor{glm::vec4(0.f)},
+        0.f, //index of refraction
+        SceneFileMap{true, std::string("scenefiles/moretextures/city.jpg"), 1.f, 1.f},
+        0.5f //blend
+    };
+}
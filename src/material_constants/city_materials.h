@@ -0,0 +1,12 @@
+#ifndef CITY_MATERIALS_H
+#define CITY_MATERIALS_H
+#include <utils/scenedata.h>
+
+// materials of the procedurally generated city (see RealtimeScene::generateProceduralCity); the texture repeat of each
+// piece is set per object
+namespace city_materials {
+    extern SceneMaterial floorMaterial;
+    extern SceneMaterial buildingMaterial;
+}
+
+#endif //CITY_MATERIALS_H
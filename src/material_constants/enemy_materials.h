@@ -13,6 +13,8 @@ namespace enemy_materials {
     extern SceneMaterial damagedEnemyMaterial2;
     extern SceneMaterial enemyMaterial3;
     extern SceneMaterial damagedEnemyMaterial3;
+    extern SceneMaterial enemyMaterial4;
+    extern SceneMaterial damagedEnemyMaterial4;
     extern SceneMaterial getRandomEnemyMaterial();
 }
 
@@ -0,0 +1,77 @@
+#include "materialregistry.h"
+#include "material_constants/city_materials.h"
+#include "material_constants/enemy_materials.h"
+
+MaterialRegistry& MaterialRegistry::global() {
+    static MaterialRegistry registry;
+    return registry;
+}
+
+MaterialRegistry::MaterialRegistry() {
+    for (const SceneMaterial* material : {
+            &enemy_materials::enemyMaterial1, &enemy_materials::damagedEnemyMaterial1,
+            &enemy_materials::enemyMaterial2, &enemy_materials::damagedEnemyMaterial2,
+            &enemy_materials::enemyMaterial3, &enemy_materials::damagedEnemyMaterial3,
+            &enemy_materials::enemyMaterial4, &enemy_materials::damagedEnemyMaterial4,
+            &city_materials::floorMaterial, &city_materials::buildingMaterial}) {
+        intern(*material);
+    }
+}
+
+MaterialID MaterialRegistry::intern(const SceneMaterial& material) {
+    auto it = m_ids.find(material);
+    if (it != m_ids.end()) {
+        return it->second;
+    }
+    auto id = (MaterialID) m_materials.size();
+    SceneMaterial& stored = m_materials.emplace_back(material);
+    stored.textureMap.repeatU = 1.f;
+    stored.textureMap.repeatV = 1.f;
+    m_ids.emplace(stored, id);
+    return id;
+}
+
+const SceneMaterial& MaterialRegistry::get(MaterialID id) const {
+    return m_materials[id];
+}
+
+size_t MaterialRegistry::size() const {
+    return m_materials.size();
+}
+
+namespace {
+    void hashCombine(std::size_t& seed, std::size_t value) {
+        // boost::hash_combine
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    void hashColor(std::size_t& seed, const SceneColor& color) {
+        for (int i = 0; i < 4; i++) {
+            hashCombine(seed, std::hash<float>()(color[i]));
+        }
+    }
+}
+
+std::size_t MaterialRegistry::Hash::operator()(const SceneMaterial& material) const {
+    std::size_t seed = 0;
+    hashColor(seed, material.cAmbient);
+    hashColor(seed, material.cDiffuse);
+    hashColor(seed, material.cSpecular);
+    hashCombine(seed, std::hash<float>()(material.shininess));
+    hashCombine(seed, std::hash<float>()(material.blend));
+    hashCombine(seed, std::hash<bool>()(material.textureMap.isUsed));
+    if (material.textureMap.isUsed) {
+        hashCombine(seed, std::hash<std::string>()(material.textureMap.filename));
+    }
+    return seed;
+}
+
+bool MaterialRegistry::Equal::operator()(const SceneMaterial& lhs, const SceneMaterial& rhs) const {
+    return lhs.cAmbient == rhs.cAmbient &&
+           lhs.cDiffuse == rhs.cDiffuse &&
+           lhs.cSpecular == rhs.cSpecular &&
+           lhs.shininess == rhs.shininess &&
+           lhs.blend == rhs.blend &&
+           lhs.textureMap.isUsed == rhs.textureMap.isUsed &&
+           (!lhs.textureMap.isUsed || lhs.textureMap.filename == rhs.textureMap.filename);
+}
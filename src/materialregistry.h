@@ -0,0 +1,44 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include "utils/scenedata.h"
+
+/// Index of a material in the MaterialRegistry
+typedef uint32_t MaterialID;
+
+/// Interned, deduplicated table of every material used by a RealtimeObject, so objects only store a MaterialID.
+/// Materials are compared by the fields the renderer uses (colors, shininess, blend and texture file); the texture repeat
+/// is stored per object instead (see RealtimeObject::uvRepeat), so e.g. every building shares one material
+class MaterialRegistry {
+public:
+    /// The registry shared by every scene; on first use it's pre-populated with the enemy and city materials
+    static MaterialRegistry& global();
+
+    /// Returns the ID of the stored material equal to `material`, adding it if there is none.
+    /// The stored copy's texture repeat is always 1
+    MaterialID intern(const SceneMaterial& material);
+    /// References stay valid for the registry's lifetime (materials are never removed)
+    const SceneMaterial& get(MaterialID id) const;
+    /// Number of distinct materials
+    size_t size() const;
+
+private:
+    MaterialRegistry();
+
+    struct Hash {
+        std::size_t operator()(const SceneMaterial& material) const;
+    };
+    struct Equal {
+        bool operator()(const SceneMaterial& lhs, const SceneMaterial& rhs) const;
+    };
+
+    /// deque so references from get() survive later interns
+    std::deque<SceneMaterial> m_materials;
+    std::unordered_map<SceneMaterial, MaterialID, Hash, Equal> m_ids;
+};
+
+#pragma clang diagnostic pop
@@ -7,90 +7,75 @@
 
 ConeMesh::ConeMesh(int param1, int param2) : PrimitiveMesh(param1, param2) {}
 
+AABB ConeMesh::localBounds() const {
+    return {glm::vec3(-0.5f), glm::vec3(0.5f)};
+}
+
 void ConeMesh::generateVertexData() {
+    m_thetas = AngleTable(param2(), 2 * glm::pi<float>());
     makeCap();
     makeSides();
 }
 
-void ConeMesh::makeCapCenterTile(glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta) {
+glm::vec3 ConeMesh::getRingPosition(float distFromCenter, int theta, float y) const {
+    return {distFromCenter * m_thetas.cos[theta], y, distFromCenter * m_thetas.sin[theta]};
+}
+
+void ConeMesh::makeCapCenterTile(VertexWriter& out, glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta) const {
     glm::vec3 normal = glm::normalize(center);
-    pushVertex(center, normal, getUV(center, ConeFaceType::BASE, (leftTheta + rightTheta) / 2));
-    pushVertex(bottomLeft, normal, getUV(bottomLeft, ConeFaceType::BASE, leftTheta));
-    pushVertex(bottomRight, normal, getUV(bottomRight, ConeFaceType::BASE, rightTheta));
+    out.push(center, normal, getUV(center, ConeFaceType::BASE, (leftTheta + rightTheta) / 2));
+    out.push(bottomLeft, normal, getUV(bottomLeft, ConeFaceType::BASE, leftTheta));
+    out.push(bottomRight, normal, getUV(bottomRight, ConeFaceType::BASE, rightTheta));
 }
 
-void ConeMesh::makeCapTile(glm::vec3 topLeft,
+void ConeMesh::makeCapTile(VertexWriter& out,
+                       glm::vec3 topLeft,
                        glm::vec3 topRight,
                        glm::vec3 bottomLeft,
                        glm::vec3 bottomRight,
                        float leftTheta,
-                       float rightTheta) {
+                       float rightTheta) const {
     glm::vec3 normal = glm::normalize(glm::vec3(0, topLeft.y, 0));
-    pushVertex(topLeft, normal, getUV(topLeft, ConeFaceType::BASE, leftTheta));
-    pushVertex(bottomLeft, normal, getUV(bottomLeft, ConeFaceType::BASE, leftTheta));
-    pushVertex(topRight, normal, getUV(topRight, ConeFaceType::BASE, rightTheta));
+    out.push(topLeft, normal, getUV(topLeft, ConeFaceType::BASE, leftTheta));
+    out.push(bottomLeft, normal, getUV(bottomLeft, ConeFaceType::BASE, leftTheta));
+    out.push(topRight, normal, getUV(topRight, ConeFaceType::BASE, rightTheta));
 
-    pushVertex(topRight, normal, getUV(topRight, ConeFaceType::BASE, rightTheta));
-    pushVertex(bottomLeft, normal, getUV(bottomLeft, ConeFaceType::BASE, leftTheta));
-    pushVertex(bottomRight, normal, getUV(bottomRight, ConeFaceType::BASE, rightTheta));
+    out.push(topRight, normal, getUV(topRight, ConeFaceType::BASE, rightTheta));
+    out.push(bottomLeft, normal, getUV(bottomLeft, ConeFaceType::BASE, leftTheta));
+    out.push(bottomRight, normal, getUV(bottomRight, ConeFaceType::BASE, rightTheta));
 }
 
-void ConeMesh::makeCapWedge(float currentTheta, float nextTheta, float y) {
+void ConeMesh::makeCapWedge(VertexWriter& out, int currentTheta, int nextTheta, float y) const {
+    float leftTheta = m_thetas.angles[currentTheta];
+    float rightTheta = m_thetas.angles[nextTheta];
     for (int i = 0; i < param1() - 1; i++) {
         float currentDistFromCenter = RADIUS_BOTTOM - (RADIUS_BOTTOM / (float)param1() * (float)i);
         float nextDistFromCenter = RADIUS_BOTTOM - (RADIUS_BOTTOM / (float)param1() * (float)(i + 1));
-        glm::vec3 bottomLeft = glm::vec3(
-                currentDistFromCenter * glm::cos(currentTheta),
-                y,
-                currentDistFromCenter * glm::sin(currentTheta)
-        );
-        glm::vec3 bottomRight = glm::vec3(
-                currentDistFromCenter * glm::cos(nextTheta),
-                y,
-                currentDistFromCenter * glm::sin(nextTheta)
-        );
-        glm::vec3 topLeft = glm::vec3(
-                nextDistFromCenter * glm::cos(currentTheta),
-                y,
-                nextDistFromCenter * glm::sin(currentTheta)
-        );
-        glm::vec3 topRight = glm::vec3(
-                nextDistFromCenter * glm::cos(nextTheta),
-                y,
-                nextDistFromCenter * glm::sin(nextTheta)
-        );
-        makeCapTile(topLeft, topRight, bottomLeft, bottomRight, currentTheta, nextTheta);
+        glm::vec3 bottomLeft = getRingPosition(currentDistFromCenter, currentTheta, y);
+        glm::vec3 bottomRight = getRingPosition(currentDistFromCenter, nextTheta, y);
+        glm::vec3 topLeft = getRingPosition(nextDistFromCenter, currentTheta, y);
+        glm::vec3 topRight = getRingPosition(nextDistFromCenter, nextTheta, y);
+        makeCapTile(out, topLeft, topRight, bottomLeft, bottomRight, leftTheta, rightTheta);
     }
     // center piece of this wedge
     float centerPieceEdgeLength = RADIUS_BOTTOM / (float)param1();
     glm::vec3 center = glm::vec3(0, y, 0);
-    glm::vec3 bottomLeft = glm::vec3(
-            centerPieceEdgeLength * glm::cos(currentTheta),
-            y,
-            centerPieceEdgeLength * glm::sin(currentTheta)
-    );
-    glm::vec3 bottomRight = glm::vec3(
-            centerPieceEdgeLength * glm::cos(nextTheta),
-            y,
-            centerPieceEdgeLength * glm::sin(nextTheta)
-    );
-    makeCapCenterTile(center, bottomLeft, bottomRight, currentTheta, nextTheta);
+    glm::vec3 bottomLeft = getRingPosition(centerPieceEdgeLength, currentTheta, y);
+    glm::vec3 bottomRight = getRingPosition(centerPieceEdgeLength, nextTheta, y);
+    makeCapCenterTile(out, center, bottomLeft, bottomRight, leftTheta, rightTheta);
 }
 
 void ConeMesh::makeCap() {
-    float thetaStep = glm::radians(360.f / (float) param2());
-    float currentTheta = 0 * thetaStep;
-    float nextTheta = 1 * thetaStep;
-    for (int i = 0; i < param2(); i++) {
+    // param1 - 1 tiles of two triangles and a center triangle per wedge
+    size_t floatsPerWedge = (2 * std::max(param1() - 1, 0) + 1) * 3 * FLOATS_PER_VERTEX;
+    generateWedges(param2(), floatsPerWedge, [this](int i, VertexWriter& out) {
         // there's something weird going on that causes me to have to swap currentTheta and nextTheta
         // from what is intuitive to me... idk and i dont feel like figuring it out right now
-        makeCapWedge(currentTheta, nextTheta, -HEIGHT / 2);
-        currentTheta += thetaStep;
-        nextTheta += thetaStep;
-    }
+        makeCapWedge(out, i, i + 1, -HEIGHT / 2);
+    });
 }
 
-void ConeMesh::makeTipTile(glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta) {
+void ConeMesh::makeTipTile(VertexWriter& out, glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta) const {
     // all credit to the anonymous student on #290 (https://edstem.org/us/courses/65180/discussion/5660567)
     // for this tip normal calculation
     glm::vec3 tipNormal = getSideTileNormal(bottomLeft) + getSideTileNormal(bottomRight);
@@ -98,32 +83,35 @@ void ConeMesh::makeTipTile(glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bot
     tipNormal = glm::normalize(tipNormal);
     tipNormal = glm::vec3(tipNormal.x, 0.5, tipNormal.z);
     tipNormal = glm::normalize(tipNormal);
-    pushVertex(center, glm::normalize(tipNormal), getUV(center, ConeFaceType::SIDE, (leftTheta + rightTheta) / 2));
-    pushVertex(bottomLeft, getSideTileNormal(bottomLeft), getUV(bottomLeft, ConeFaceType::SIDE, leftTheta));
-    pushVertex(bottomRight, getSideTileNormal(bottomRight), getUV(bottomRight, ConeFaceType::SIDE, rightTheta));
+    out.push(center, glm::normalize(tipNormal), getUV(center, ConeFaceType::SIDE, (leftTheta + rightTheta) / 2));
+    out.push(bottomLeft, getSideTileNormal(bottomLeft), getUV(bottomLeft, ConeFaceType::SIDE, leftTheta));
+    out.push(bottomRight, getSideTileNormal(bottomRight), getUV(bottomRight, ConeFaceType::SIDE, rightTheta));
 }
 
 glm::vec3 ConeMesh::getSideTileNormal(glm::vec3 point) {
     return glm::normalize(glm::vec3(2.f * point.x, -0.5f * point.y + 0.25f, 2.f * point.z));
 }
 
-void ConeMesh::makeSideTile(glm::vec3 topLeft,
+void ConeMesh::makeSideTile(VertexWriter& out,
+                        glm::vec3 topLeft,
                         glm::vec3 topRight,
                         glm::vec3 bottomLeft,
                         glm::vec3 bottomRight,
                         float leftTheta,
-                        float rightTheta) {
+                        float rightTheta) const {
     // these vertices should be on the implicit cone, so the normal can just be computed the same way
-    pushVertex(topLeft, getSideTileNormal(topLeft), getUV(topLeft, ConeFaceType::SIDE, leftTheta));
-    pushVertex(bottomRight, getSideTileNormal(bottomRight), getUV(bottomRight, ConeFaceType::SIDE, rightTheta));
-    pushVertex(topRight, getSideTileNormal(topRight), getUV(topRight, ConeFaceType::SIDE, rightTheta));
+    out.push(topLeft, getSideTileNormal(topLeft), getUV(topLeft, ConeFaceType::SIDE, leftTheta));
+    out.push(bottomRight, getSideTileNormal(bottomRight), getUV(bottomRight, ConeFaceType::SIDE, rightTheta));
+    out.push(topRight, getSideTileNormal(topRight), getUV(topRight, ConeFaceType::SIDE, rightTheta));
 
-    pushVertex(topLeft, getSideTileNormal(topLeft), getUV(topLeft, ConeFaceType::SIDE, leftTheta));
-    pushVertex(bottomLeft, getSideTileNormal(bottomLeft), getUV(bottomLeft, ConeFaceType::SIDE, leftTheta));
-    pushVertex(bottomRight, getSideTileNormal(bottomRight), getUV(bottomRight, ConeFaceType::SIDE, rightTheta));
+    out.push(topLeft, getSideTileNormal(topLeft), getUV(topLeft, ConeFaceType::SIDE, leftTheta));
+    out.push(bottomLeft, getSideTileNormal(bottomLeft), getUV(bottomLeft, ConeFaceType::SIDE, leftTheta));
+    out.push(bottomRight, getSideTileNormal(bottomRight), getUV(bottomRight, ConeFaceType::SIDE, rightTheta));
 }
 
-void ConeMesh::makeSide(float currentTheta, float nextTheta) {
+void ConeMesh::makeSide(VertexWriter& out, int currentTheta, int nextTheta) const {
+    float leftTheta = m_thetas.angles[currentTheta];
+    float rightTheta = m_thetas.angles[nextTheta];
     for (int j = 0; j < param1(); j++) {
         float currentDistFromBottom = HEIGHT / (float) param1() * (float) j;
         float nextDistFromBottom = HEIGHT / (float) param1() * (float) (j + 1);
@@ -131,43 +119,24 @@ void ConeMesh::makeSide(float currentTheta, float nextTheta) {
         float nextY = -HEIGHT / 2.0f + nextDistFromBottom;
         float currentPercentToBottom = 1.f - (float) j / (float) param1();
         float nextPercentToBottom = 1.f - (float) (j + 1) / (float) param1();
-        glm::vec3 bottomLeft = glm::vec3(
-                currentPercentToBottom * RADIUS_BOTTOM * glm::cos(currentTheta),
-                currentY,
-                currentPercentToBottom * RADIUS_BOTTOM * glm::sin(currentTheta)
-        );
-        glm::vec3 bottomRight = glm::vec3(
-                currentPercentToBottom * RADIUS_BOTTOM * glm::cos(nextTheta),
-                currentY,
-                currentPercentToBottom * RADIUS_BOTTOM * glm::sin(nextTheta)
-        );
+        glm::vec3 bottomLeft = getRingPosition(currentPercentToBottom * RADIUS_BOTTOM, currentTheta, currentY);
+        glm::vec3 bottomRight = getRingPosition(currentPercentToBottom * RADIUS_BOTTOM, nextTheta, currentY);
         if (j == param1() - 1) {
-            makeTipTile(glm::vec3(0, nextY, 0), bottomLeft, bottomRight, currentTheta, nextTheta);
+            makeTipTile(out, glm::vec3(0, nextY, 0), bottomLeft, bottomRight, leftTheta, rightTheta);
         } else {
-            glm::vec3 topLeft = glm::vec3(
-                    nextPercentToBottom * RADIUS_BOTTOM * glm::cos(currentTheta),
-                    nextY,
-                    nextPercentToBottom * RADIUS_BOTTOM * glm::sin(currentTheta)
-            );
-            glm::vec3 topRight = glm::vec3(
-                    nextPercentToBottom * RADIUS_BOTTOM * glm::cos(nextTheta),
-                    nextY,
-                    nextPercentToBottom * RADIUS_BOTTOM * glm::sin(nextTheta)
-            );
-            makeSideTile(topLeft, topRight, bottomLeft, bottomRight, currentTheta, nextTheta);
+            glm::vec3 topLeft = getRingPosition(nextPercentToBottom * RADIUS_BOTTOM, currentTheta, nextY);
+            glm::vec3 topRight = getRingPosition(nextPercentToBottom * RADIUS_BOTTOM, nextTheta, nextY);
+            makeSideTile(out, topLeft, topRight, bottomLeft, bottomRight, leftTheta, rightTheta);
         }
     }
 }
 
 void ConeMesh::makeSides() {
-    float thetaStep = glm::radians(360.f / (float) param2());
-    float currentTheta = 0 * thetaStep;
-    float nextTheta = 1 * thetaStep;
-    for (int i = 0; i < param2(); i++) {
-        makeSide(nextTheta, currentTheta);
-        currentTheta += thetaStep;
-        nextTheta += thetaStep;
-    }
+    // param1 - 1 tiles of two triangles and the tip triangle per wedge
+    size_t floatsPerWedge = (2 * std::max(param1() - 1, 0) + 1) * 3 * FLOATS_PER_VERTEX;
+    generateWedges(param2(), floatsPerWedge, [this](int i, VertexWriter& out) {
+        makeSide(out, i + 1, i);
+    });
 }
 
 int ConeMesh::getMinParam1() const {
@@ -11,6 +11,8 @@ enum class ConeFaceType {
 class ConeMesh : public PrimitiveMesh {
 public:
     ConeMesh(int param1, int param2);
+    /// The ideal cone just touches every face of the unit cube, whatever the tessellation
+    AABB localBounds() const override;
 protected:
     int getMinParam1() const override;
     int getMinParam2() const override;
@@ -18,16 +20,20 @@ protected:
     void generateVertexData() override;
 private:
     static glm::vec2 getUV(glm::vec3 pos, ConeFaceType face, float theta);
-    void makeCapTile(glm::vec3 topLeft, glm::vec3 topRight, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta);
-    void makeCapCenterTile(glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta);
-    void makeCapWedge(float currentTheta, float nextTheta, float y);
+    /// Point at the given distance from the axis, at the angle with the given index into m_thetas
+    glm::vec3 getRingPosition(float distFromCenter, int theta, float y) const;
+    // the wedges take indices into m_thetas; the tiles take the angles themselves, for the uvs
+    void makeCapTile(VertexWriter& out, glm::vec3 topLeft, glm::vec3 topRight, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta) const;
+    void makeCapCenterTile(VertexWriter& out, glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta) const;
+    void makeCapWedge(VertexWriter& out, int currentTheta, int nextTheta, float y) const;
     void makeCap();
-
     static glm::vec3 getSideTileNormal(glm::vec3 point);
-    void makeSideTile(glm::vec3 topLeft, glm::vec3 topRight, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta);
-    void makeTipTile(glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta);
-    void makeSide(float currentTheta, float nextTheta);
+    void makeSideTile(VertexWriter& out, glm::vec3 topLeft, glm::vec3 topRight, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta) const;
+    void makeTipTile(VertexWriter& out, glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta) const;
+    void makeSide(VertexWriter& out, int currentTheta, int nextTheta) const;
     void makeSides();
+    /// Angle of each wedge boundary; rebuilt whenever the vertex data is generated
+    AngleTable m_thetas;
 };
 
 
@@ -1,45 +1,10 @@
 #include "cubemesh.h"
 #include "primitivemesh.h"
-#include <optional>
 
 CubeMesh::CubeMesh(int param1, int param2) : PrimitiveMesh(param1, param2) {}
 
-AABB CubeMesh::computeAABB(const glm::mat4& ctm) const {
-    // the most extreme points are the corners of the cube, so we can transform those and find the min and max
-    std::optional<glm::vec3> min = std::nullopt;
-    std::optional<glm::vec3> max = std::nullopt;
-    for (float x : {-0.5f, 0.5f}) {
-        for (float y : {-0.5f, 0.5f}) {
-            for (float z : {-0.5f, 0.5f}) {
-                glm::vec3 transformed = glm::vec3(ctm * glm::vec4(x, y, z, 1));
-                if (!min) {
-                    min = transformed;
-                }
-                if (!max) {
-                    max = transformed;
-                }
-                if (transformed.x < min->x) {
-                    min->x = transformed.x;
-                }
-                if (transformed.y < min->y) {
-                    min->y = transformed.y;
-                }
-                if (transformed.z < min->z) {
-                    min->z = transformed.z;
-                }
-                if (transformed.x > max->x) {
-                    max->x = transformed.x;
-                }
-                if (transformed.y > max->y) {
-                    max->y = transformed.y;
-                }
-                if (transformed.z > max->z) {
-                    max->z = transformed.z;
-                }
-            }
-        }
-    }
-    return {min.value(), max.value()};
+AABB CubeMesh::localBounds() const {
+    return {glm::vec3(-0.5f), glm::vec3(0.5f)};
 }
 
 int CubeMesh::getMinParam1() const {
@@ -112,16 +77,15 @@ void CubeMesh::makeFace(glm::vec3 topLeft,
     float tileHeight = totalHeight / (float) param1();
     glm::vec3 rightVec = glm::normalize(topRight - topLeft);
     glm::vec3 downVec = glm::normalize(bottomLeft - topLeft);
+    // the whole face is flat, so every vertex gets the same normal
+    glm::vec3 normal = glm::normalize(glm::cross(downVec, rightVec));
+    // every tile computes a shared corner the same way, so the corners come out bit-identical and can be welded
+    auto corner = [&](int i, int j) {
+        return topLeft + (float) i * tileWidth * rightVec + (float) j * tileHeight * downVec;
+    };
     for (int i = 0; i < param1(); i++) {
         for (int j = 0; j < param1(); j++) {
-            glm::vec3 tileTopLeft = topLeft + (float) i * tileWidth * rightVec + (float) j * tileHeight * downVec;
-            makeTile(
-                    tileTopLeft,
-                    tileTopLeft + tileWidth * rightVec,
-                    tileTopLeft + tileHeight * downVec,
-                    tileTopLeft + tileWidth * rightVec + tileHeight * downVec,
-                    face
-            );
+            makeTile(corner(i, j), corner(i + 1, j), corner(i, j + 1), corner(i + 1, j + 1), normal, face);
         }
     }
 }
@@ -130,14 +94,15 @@ void CubeMesh::makeTile(glm::vec3 topLeft,
                     glm::vec3 topRight,
                     glm::vec3 bottomLeft,
                     glm::vec3 bottomRight,
+                    glm::vec3 normal,
                     CubeFaceType face) {
-    pushVertex(topLeft, glm::normalize(glm::cross(bottomLeft - topLeft, bottomRight - topLeft)), getUV(topLeft, face));
-    pushVertex(bottomRight, glm::normalize(glm::cross(topLeft - bottomRight, bottomLeft - bottomRight)), getUV(bottomRight, face));
-    pushVertex(topRight, glm::normalize(glm::cross(topLeft - topRight, bottomRight - topRight)), getUV(topRight, face));
+    pushVertex(topLeft, normal, getUV(topLeft, face));
+    pushVertex(bottomRight, normal, getUV(bottomRight, face));
+    pushVertex(topRight, normal, getUV(topRight, face));
 
-    pushVertex(topLeft, glm::normalize(glm::cross(bottomRight - topLeft, topRight - topLeft)), getUV(topLeft, face));
-    pushVertex(bottomLeft, glm::normalize(glm::cross(bottomRight - bottomLeft, topLeft - bottomLeft)), getUV(bottomLeft, face));
-    pushVertex(bottomRight, glm::normalize(glm::cross(topRight - bottomRight, topLeft - bottomRight)), getUV(bottomRight, face));
+    pushVertex(topLeft, normal, getUV(topLeft, face));
+    pushVertex(bottomLeft, normal, getUV(bottomLeft, face));
+    pushVertex(bottomRight, normal, getUV(bottomRight, face));
 }
 
 glm::vec2 CubeMesh::getUV(glm::vec3 pos, CubeFaceType face) {
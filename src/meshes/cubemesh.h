@@ -15,7 +15,7 @@ enum class CubeFaceType {
 class CubeMesh : public PrimitiveMesh {
 public:
     CubeMesh(int param1, int param2);
-    AABB computeAABB(const glm::mat4& ctm) const override;
+    AABB localBounds() const override;
 protected:
     int getMinParam1() const override;
     int getMinParam2() const override;
@@ -28,6 +28,7 @@ private:
                   glm::vec3 topRight,
                   glm::vec3 bottomLeft,
                   glm::vec3 bottomRight,
+                  glm::vec3 normal,
                   CubeFaceType face);
     // bottom right can be derived since we know these are all squares!
     void makeFace(glm::vec3 topLeft,
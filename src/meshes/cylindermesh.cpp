@@ -7,148 +7,117 @@
 
 CylinderMesh::CylinderMesh(int param1, int param2) : PrimitiveMesh(param1, param2) {}
 
+AABB CylinderMesh::localBounds() const {
+    return {glm::vec3(-0.5f), glm::vec3(0.5f)};
+}
+
 void CylinderMesh::generateVertexData() {
+    m_thetas = AngleTable(param2(), 2 * glm::pi<float>());
     makeCaps();
     makeSides();
 }
 
-void CylinderMesh::makeCapCenterTile(glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, CylinderFaceType face, float leftTheta, float rightTheta) {
+glm::vec3 CylinderMesh::getRingPosition(float distFromCenter, int theta, float y) const {
+    return {distFromCenter * m_thetas.cos[theta], y, distFromCenter * m_thetas.sin[theta]};
+}
+
+void CylinderMesh::makeCapCenterTile(VertexWriter& out, glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, CylinderFaceType face, float leftTheta, float rightTheta) const {
     glm::vec3 normal = glm::normalize(center);
-    pushVertex(center, normal, getUV(center, face, (leftTheta + rightTheta) / 2));
-    pushVertex(bottomLeft, normal, getUV(bottomLeft, face, leftTheta));
-    pushVertex(bottomRight, normal, getUV(bottomRight, face, rightTheta));
+    out.push(center, normal, getUV(center, face, (leftTheta + rightTheta) / 2));
+    out.push(bottomLeft, normal, getUV(bottomLeft, face, leftTheta));
+    out.push(bottomRight, normal, getUV(bottomRight, face, rightTheta));
 }
 
-void CylinderMesh::makeCapTile(glm::vec3 topLeft,
+void CylinderMesh::makeCapTile(VertexWriter& out,
+                           glm::vec3 topLeft,
                            glm::vec3 topRight,
                            glm::vec3 bottomLeft,
                            glm::vec3 bottomRight,
                            CylinderFaceType face,
                            float leftTheta,
-                           float rightTheta) {
+                           float rightTheta) const {
     glm::vec3 normal = glm::normalize(glm::vec3(0, topLeft.y, 0));
-    pushVertex(topLeft, normal, getUV(topLeft, face, leftTheta));
-    pushVertex(bottomLeft, normal, getUV(bottomLeft, face, leftTheta));
-    pushVertex(topRight, normal, getUV(topRight, face, rightTheta));
+    out.push(topLeft, normal, getUV(topLeft, face, leftTheta));
+    out.push(bottomLeft, normal, getUV(bottomLeft, face, leftTheta));
+    out.push(topRight, normal, getUV(topRight, face, rightTheta));
 
-    pushVertex(topRight, normal, getUV(topRight, face, rightTheta));
-    pushVertex(bottomLeft, normal, getUV(bottomLeft, face, leftTheta));
-    pushVertex(bottomRight, normal, getUV(bottomRight, face, rightTheta));
+    out.push(topRight, normal, getUV(topRight, face, rightTheta));
+    out.push(bottomLeft, normal, getUV(bottomLeft, face, leftTheta));
+    out.push(bottomRight, normal, getUV(bottomRight, face, rightTheta));
 }
 
-void CylinderMesh::makeCapWedge(float currentTheta, float nextTheta, float y, CylinderFaceType face, float leftTheta, float rightTheta) {
+void CylinderMesh::makeCapWedge(VertexWriter& out, int currentTheta, int nextTheta, float y, CylinderFaceType face) const {
+    float leftTheta = m_thetas.angles[currentTheta];
+    float rightTheta = m_thetas.angles[nextTheta];
     for (int i = 0; i < param1() - 1; i++) {
         float currentDistFromCenter = RADIUS - (RADIUS / (float)param1() * (float)i);
         float nextDistFromCenter = RADIUS - (RADIUS / (float)param1() * (float)(i + 1));
-        glm::vec3 bottomLeft = glm::vec3(
-                currentDistFromCenter * glm::cos(currentTheta),
-                y,
-                currentDistFromCenter * glm::sin(currentTheta)
-        );
-        glm::vec3 bottomRight = glm::vec3(
-                currentDistFromCenter * glm::cos(nextTheta),
-                y,
-                currentDistFromCenter * glm::sin(nextTheta)
-        );
-        glm::vec3 topLeft = glm::vec3(
-                nextDistFromCenter * glm::cos(currentTheta),
-                y,
-                nextDistFromCenter * glm::sin(currentTheta)
-        );
-        glm::vec3 topRight = glm::vec3(
-                nextDistFromCenter * glm::cos(nextTheta),
-                y,
-                nextDistFromCenter * glm::sin(nextTheta)
-        );
-        makeCapTile(topLeft, topRight, bottomLeft, bottomRight, face, currentTheta, nextTheta);
+        glm::vec3 bottomLeft = getRingPosition(currentDistFromCenter, currentTheta, y);
+        glm::vec3 bottomRight = getRingPosition(currentDistFromCenter, nextTheta, y);
+        glm::vec3 topLeft = getRingPosition(nextDistFromCenter, currentTheta, y);
+        glm::vec3 topRight = getRingPosition(nextDistFromCenter, nextTheta, y);
+        makeCapTile(out, topLeft, topRight, bottomLeft, bottomRight, face, leftTheta, rightTheta);
     }
     // center piece of this wedge
     float centerPieceEdgeLength = RADIUS / (float)param1();
     glm::vec3 center = glm::vec3(0, y, 0);
-    glm::vec3 bottomLeft = glm::vec3(
-            centerPieceEdgeLength * glm::cos(currentTheta),
-            y,
-            centerPieceEdgeLength * glm::sin(currentTheta)
-    );
-    glm::vec3 bottomRight = glm::vec3(
-            centerPieceEdgeLength * glm::cos(nextTheta),
-            y,
-            centerPieceEdgeLength * glm::sin(nextTheta)
-    );
-    makeCapCenterTile(center, bottomLeft, bottomRight, face, currentTheta, nextTheta);
+    glm::vec3 bottomLeft = getRingPosition(centerPieceEdgeLength, currentTheta, y);
+    glm::vec3 bottomRight = getRingPosition(centerPieceEdgeLength, nextTheta, y);
+    makeCapCenterTile(out, center, bottomLeft, bottomRight, face, leftTheta, rightTheta);
 }
 
 void CylinderMesh::makeCaps() {
     float cylinderHeight = 1.0;
-    float thetaStep = glm::radians(360.f / (float) param2());
-    float currentTheta = 0 * thetaStep;
-    float nextTheta = 1 * thetaStep;
-    for (int i = 0; i < param2(); i++) {
+    // each cap wedge is param1 - 1 tiles of two triangles and a center triangle, and each step makes one per cap
+    size_t floatsPerCapWedge = (2 * std::max(param1() - 1, 0) + 1) * 3 * FLOATS_PER_VERTEX;
+    generateWedges(param2(), 2 * floatsPerCapWedge, [this, cylinderHeight](int i, VertexWriter& out) {
         // there's something weird going on that causes me to have to swap currentTheta and nextTheta
         // from what is intuitive to me... idk and i dont feel like figuring it out right now
-        makeCapWedge(nextTheta, currentTheta, cylinderHeight / 2, CylinderFaceType::TOP_CAP, currentTheta, nextTheta);
-        makeCapWedge(currentTheta, nextTheta, -cylinderHeight / 2, CylinderFaceType::BOTTOM_CAP, currentTheta, nextTheta);
-        currentTheta += thetaStep;
-        nextTheta += thetaStep;
-    }
+        makeCapWedge(out, i + 1, i, cylinderHeight / 2, CylinderFaceType::TOP_CAP);
+        makeCapWedge(out, i, i + 1, -cylinderHeight / 2, CylinderFaceType::BOTTOM_CAP);
+    });
 }
 
-void CylinderMesh::makeSideTile(glm::vec3 topLeft,
+void CylinderMesh::makeSideTile(VertexWriter& out,
+                            glm::vec3 topLeft,
                             glm::vec3 topRight,
                             glm::vec3 bottomLeft,
                             glm::vec3 bottomRight,
+                            glm::vec3 leftNormal,
+                            glm::vec3 rightNormal,
                             float leftTheta,
-                            float rightTheta) {
-    glm::vec3 leftNormal = glm::normalize(glm::vec3(topLeft.x, 0, topLeft.z));
-    glm::vec3 rightNormal = glm::normalize(glm::vec3(topRight.x, 0, topRight.z));
-    pushVertex(topLeft, leftNormal, getUV(topLeft, CylinderFaceType::SIDE, leftTheta));
-    pushVertex(bottomRight, rightNormal, getUV(bottomRight, CylinderFaceType::SIDE, rightTheta));
-    pushVertex(topRight, rightNormal, getUV(topRight, CylinderFaceType::SIDE, rightTheta));
-
-    pushVertex(topLeft, leftNormal, getUV(topLeft, CylinderFaceType::SIDE, leftTheta));
-    pushVertex(bottomLeft, leftNormal, getUV(bottomLeft, CylinderFaceType::SIDE, leftTheta));
-    pushVertex(bottomRight, rightNormal, getUV(bottomRight, CylinderFaceType::SIDE, rightTheta));
+                            float rightTheta) const {
+    out.push(topLeft, leftNormal, getUV(topLeft, CylinderFaceType::SIDE, leftTheta));
+    out.push(bottomRight, rightNormal, getUV(bottomRight, CylinderFaceType::SIDE, rightTheta));
+    out.push(topRight, rightNormal, getUV(topRight, CylinderFaceType::SIDE, rightTheta));
+
+    out.push(topLeft, leftNormal, getUV(topLeft, CylinderFaceType::SIDE, leftTheta));
+    out.push(bottomLeft, leftNormal, getUV(bottomLeft, CylinderFaceType::SIDE, leftTheta));
+    out.push(bottomRight, rightNormal, getUV(bottomRight, CylinderFaceType::SIDE, rightTheta));
 }
 
-void CylinderMesh::makeSide(float currentTheta, float nextTheta) {
+void CylinderMesh::makeSide(VertexWriter& out, int currentTheta, int nextTheta) const {
+    // the side normals only depend on theta
+    glm::vec3 leftNormal = glm::vec3(m_thetas.cos[currentTheta], 0, m_thetas.sin[currentTheta]);
+    glm::vec3 rightNormal = glm::vec3(m_thetas.cos[nextTheta], 0, m_thetas.sin[nextTheta]);
     for (int j = 0; j < param1(); j++) {
         float currentDistFromBottom = HEIGHT / (float) param1() * (float) j;
         float nextDistFromBottom = HEIGHT / (float) param1() * (float) (j + 1);
         float currentY = -HEIGHT / 2.0f + currentDistFromBottom;
         float nextY = -HEIGHT / 2.0f + nextDistFromBottom;
-        glm::vec3 bottomLeft = glm::vec3(
-                RADIUS * glm::cos(currentTheta),
-                currentY,
-                RADIUS * glm::sin(currentTheta)
-        );
-        glm::vec3 bottomRight = glm::vec3(
-                RADIUS * glm::cos(nextTheta),
-                currentY,
-                RADIUS * glm::sin(nextTheta)
-        );
-        glm::vec3 topLeft = glm::vec3(
-                RADIUS * glm::cos(currentTheta),
-                nextY,
-                RADIUS * glm::sin(currentTheta)
-        );
-        glm::vec3 topRight = glm::vec3(
-                RADIUS * glm::cos(nextTheta),
-                nextY,
-                RADIUS * glm::sin(nextTheta)
-        );
-        makeSideTile(topLeft, topRight, bottomLeft, bottomRight, currentTheta, nextTheta);
+        glm::vec3 bottomLeft = getRingPosition(RADIUS, currentTheta, currentY);
+        glm::vec3 bottomRight = getRingPosition(RADIUS, nextTheta, currentY);
+        glm::vec3 topLeft = getRingPosition(RADIUS, currentTheta, nextY);
+        glm::vec3 topRight = getRingPosition(RADIUS, nextTheta, nextY);
+        makeSideTile(out, topLeft, topRight, bottomLeft, bottomRight, leftNormal, rightNormal,
+                     m_thetas.angles[currentTheta], m_thetas.angles[nextTheta]);
     }
 }
 
 void CylinderMesh::makeSides() {
-    float thetaStep = glm::radians(360.f / (float) param2());
-    float currentTheta = 0 * thetaStep;
-    float nextTheta = 1 * thetaStep;
-    for (int i = 0; i < param2(); i++) {
-        makeSide(nextTheta, currentTheta);
-        currentTheta += thetaStep;
-        nextTheta += thetaStep;
-    }
+    generateWedges(param2(), param1() * 2 * 3 * FLOATS_PER_VERTEX, [this](int i, VertexWriter& out) {
+        makeSide(out, i + 1, i);
+    });
 }
 
 int CylinderMesh::getMinParam1() const {
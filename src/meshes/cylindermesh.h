@@ -12,6 +12,8 @@ enum class CylinderFaceType {
 class CylinderMesh : public PrimitiveMesh {
 public:
     CylinderMesh(int param1, int param2);
+    /// The ideal cylinder just touches every face of the unit cube, whatever the tessellation
+    AABB localBounds() const override;
 protected:
     int getMinParam1() const override;
     int getMinParam2() const override;
@@ -19,21 +21,33 @@ protected:
     void generateVertexData() override;
 private:
     static glm::vec2 getUV(glm::vec3 pos, CylinderFaceType face, float theta);
-
-    void makeCapCenterTile(glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, CylinderFaceType face, float leftTheta, float rightTheta);
-    void makeCapTile(glm::vec3 topLeft,
+    /// Point at the given distance from the axis, at the angle with the given index into m_thetas
+    glm::vec3 getRingPosition(float distFromCenter, int theta, float y) const;
+    // the wedges take indices into m_thetas; the tiles take the angles themselves, for the uvs
+    void makeCapCenterTile(VertexWriter& out, glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, CylinderFaceType face, float leftTheta, float rightTheta) const;
+    void makeCapTile(VertexWriter& out,
+                     glm::vec3 topLeft,
                      glm::vec3 topRight,
                      glm::vec3 bottomLeft,
                      glm::vec3 bottomRight,
                      CylinderFaceType face,
                      float leftTheta,
-                     float rightTheta);
-    void makeCapWedge(float currentTheta, float nextTheta, float z, CylinderFaceType face, float leftTheta, float rightTheta);
+                     float rightTheta) const;
+    void makeCapWedge(VertexWriter& out, int currentTheta, int nextTheta, float y, CylinderFaceType face) const;
     void makeCaps();
-
-    void makeSideTile(glm::vec3 topLeft, glm::vec3 topRight, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta);
-    void makeSide(float currentTheta, float nextTheta);
+    void makeSideTile(VertexWriter& out,
+                      glm::vec3 topLeft,
+                      glm::vec3 topRight,
+                      glm::vec3 bottomLeft,
+                      glm::vec3 bottomRight,
+                      glm::vec3 leftNormal,
+                      glm::vec3 rightNormal,
+                      float leftTheta,
+                      float rightTheta) const;
+    void makeSide(VertexWriter& out, int currentTheta, int nextTheta) const;
     void makeSides();
+    /// Angle of each wedge boundary; rebuilt whenever the vertex data is generated
+    AngleTable m_thetas;
 };
 
 
@@ -2,13 +2,47 @@
 #pragma ide diagnostic ignored "cppcoreguidelines-pro-type-member-init"
 
 #include <iostream>
-#include <optional>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include "primitivemesh.h"
 #include "cubemesh.h"
 #include "spheremesh.h"
 #include "cylindermesh.h"
 #include "conemesh.h"
 #include "skymesh.h"
+#include "settings.h"
+
+/// How far outside [0, 1] a uv may be (from rounding in the tessellation) and still be packed; it's clamped when packed
+#define PACKED_UV_TOLERANCE 1e-4f
+
+namespace {
+    /// Converts a float in [-1, 1] to a normalized integer with the given number of bits, as GL will read it back
+    int32_t toSnorm(float value, int bits) {
+        float scale = (float) ((1 << (bits - 1)) - 1);
+        return (int32_t) std::lround(std::clamp(value, -1.f, 1.f) * scale);
+    }
+
+    PackedVertex packVertex(const float* vertex) {
+        PackedVertex packed{};
+        for (int i = 0; i < 3; i++) {
+            packed.position[i] = (int16_t) toSnorm(vertex[i], 16);
+        }
+        uint32_t normal = 0;
+        for (int i = 0; i < 3; i++) {
+            normal |= ((uint32_t) toSnorm(vertex[3 + i], 10) & 0x3FFu) << (10 * i);
+        }
+        packed.normal = normal;
+        for (int i = 0; i < 2; i++) {
+            packed.uv[i] = (uint16_t) std::lround(std::clamp(vertex[6 + i], 0.f, 1.f) * 65535.f);
+        }
+        return packed;
+    }
+}
 
 std::map<PrimitiveType, std::shared_ptr<PrimitiveMesh>>
 PrimitiveMesh::initMeshes(int param1, int param2) {
@@ -19,49 +53,33 @@ PrimitiveMesh::initMeshes(int param1, int param2) {
     meshes[PrimitiveType::PRIMITIVE_CONE] = std::make_shared<ConeMesh>(param1, param2);
     meshes[PrimitiveType::PRIMITIVE_SKYBOX] = std::make_shared<SkyMesh>(param1, param2);
 
+    // the coarser levels of each LOD chain (the skybox always fills the screen, so it doesn't get one)
+    for (int level = 1; level < LOD_LEVELS; level++) {
+        meshes[PrimitiveType::PRIMITIVE_CUBE]->m_lods.push_back(std::make_shared<CubeMesh>(param1, param2));
+        meshes[PrimitiveType::PRIMITIVE_SPHERE]->m_lods.push_back(std::make_shared<SphereMesh>(param1, param2));
+        meshes[PrimitiveType::PRIMITIVE_CYLINDER]->m_lods.push_back(std::make_shared<CylinderMesh>(param1, param2));
+        meshes[PrimitiveType::PRIMITIVE_CONE]->m_lods.push_back(std::make_shared<ConeMesh>(param1, param2));
+    }
+
+    // generate the vertex data now rather than on the first updateBuffers() (the constructors can't do it since it's
+    // virtual), so everything on the CPU side (e.g. AABBs) works without a GL context
+    for (auto& [_, mesh] : meshes) {
+        mesh->setParams(param1, param2);
+    }
     return meshes;
 }
 
 PrimitiveMesh::PrimitiveMesh(int param1, int param2): m_param1(param1), m_param2(param2) {}
 
-// default implementation for AABB that just uses the mesh bounds
-// TODO make sure eventually this is overridden in all subclasses so that the AABB is on the ideal object bounds, not the mesh
 AABB PrimitiveMesh::computeAABB(const glm::mat4& ctm) const {
-    // TODO ensure that if we use this default implementation, we update it if param1 or param2 change
-    if (m_vertexData.empty()) {
-        throw std::runtime_error("Trying to compute AABB from mesh when vertex data is empty");
-    }
+    return localBounds().transformed(ctm);
+}
 
-    std::optional<glm::vec3> min = std::nullopt;
-    std::optional<glm::vec3> max = std::nullopt;
-    for (size_t i = 0; i < m_vertexData.size(); i += FLOATS_PER_VERTEX) {
-        glm::vec3 transformed = glm::vec3(ctm * glm::vec4(m_vertexData[i], m_vertexData[i + 1], m_vertexData[i + 2], 1));
-        if (!min) {
-            min = transformed;
-        }
-        if (!max) {
-            max = transformed;
-        }
-        if (transformed.x < min->x) {
-            min->x = transformed.x;
-        }
-        if (transformed.y < min->y) {
-            min->y = transformed.y;
-        }
-        if (transformed.z < min->z) {
-            min->z = transformed.z;
-        }
-        if (transformed.x > max->x) {
-            max->x = transformed.x;
-        }
-        if (transformed.y > max->y) {
-            max->y = transformed.y;
-        }
-        if (transformed.z > max->z) {
-            max->z = transformed.z;
-        }
+AABB PrimitiveMesh::localBounds() const {
+    if (m_indexedVertexData.empty()) {
+        throw std::runtime_error("Trying to compute AABB from mesh when vertex data is empty");
     }
-    return {min.value(), max.value()};
+    return m_vertexBounds;
 }
 
 void PrimitiveMesh::setParams(int param1, int param2) {
@@ -78,6 +96,73 @@ void PrimitiveMesh::setParams(int param1, int param2) {
     m_vertexData.clear();
     m_vertexData.reserve(getExpectedVectorSize());
     generateVertexData();
+    weldVertices();
+    for (size_t i = 0; i < m_lods.size(); i++) {
+        // level i + 1 halves the parameters i + 1 times; setParams clamps them to the shape's minimums
+        m_lods[i]->setParams(param1 >> (i + 1), param2 >> (i + 1));
+    }
+}
+
+const PrimitiveMesh& PrimitiveMesh::lod(int level) const {
+    if (level <= 0 || m_lods.empty()) {
+        return *this;
+    }
+    return *m_lods[std::min((size_t) level, m_lods.size()) - 1];
+}
+
+int PrimitiveMesh::lodCount() const {
+    return (int) m_lods.size() + 1;
+}
+
+int PrimitiveMesh::lodLevelFor(float screenSize) {
+    if (screenSize >= LOD_LEVEL1_SCREEN_SIZE) {
+        return 0;
+    }
+    if (screenSize >= LOD_LEVEL2_SCREEN_SIZE) {
+        return 1;
+    }
+    return 2;
+}
+
+int PrimitiveMesh::selectLOD(float screenSize, int currentLevel) {
+    // only go coarser if the object would be coarser even if it were a bit bigger, and vice versa
+    int coarser = lodLevelFor(screenSize * (1.f + LOD_HYSTERESIS));
+    if (coarser > currentLevel) {
+        return coarser;
+    }
+    int finer = lodLevelFor(screenSize * (1.f - LOD_HYSTERESIS));
+    if (finer < currentLevel) {
+        return finer;
+    }
+    return currentLevel;
+}
+
+void PrimitiveMesh::weldVertices() {
+    size_t numVertices = m_vertexData.size() / FLOATS_PER_VERTEX;
+    m_indexedVertexData.clear();
+    m_indices.clear();
+    m_indices.reserve(numVertices);
+    // keyed on the raw bytes of each vertex's floats in m_vertexData, so only exact duplicates are merged
+    std::unordered_map<std::string_view, GLuint> indexOf;
+    indexOf.reserve(numVertices);
+    for (size_t i = 0; i < numVertices; i++) {
+        const float* vertex = &m_vertexData[i * FLOATS_PER_VERTEX];
+        std::string_view key(reinterpret_cast<const char*>(vertex), FLOATS_PER_VERTEX * sizeof(float));
+        auto [it, inserted] = indexOf.try_emplace(key, (GLuint) (m_indexedVertexData.size() / FLOATS_PER_VERTEX));
+        if (inserted) {
+            m_indexedVertexData.insert(m_indexedVertexData.end(), vertex, vertex + FLOATS_PER_VERTEX);
+            glm::vec3 position(vertex[0], vertex[1], vertex[2]);
+            if (m_indexedVertexData.size() == FLOATS_PER_VERTEX) {
+                m_vertexBounds = AABB{position, position};
+            } else {
+                m_vertexBounds.min = glm::min(m_vertexBounds.min, position);
+                m_vertexBounds.max = glm::max(m_vertexBounds.max, position);
+            }
+        }
+        m_indices.push_back(it->second);
+    }
+    m_vertexCount = (GLsizei) numVertices;
+    m_indexCount = (GLsizei) m_indices.size();
 }
 
 int PrimitiveMesh::param1() const {
@@ -103,6 +188,47 @@ void PrimitiveMesh::pushVertex(glm::vec3 v, glm::vec3 n, glm::vec2 uv) {
     m_vertexData.push_back(uv.y);
 }
 
+AngleTable::AngleTable(int steps, float range) {
+    angles.resize(steps + 1);
+    cos.resize(steps + 1);
+    sin.resize(steps + 1);
+    for (int i = 0; i <= steps; i++) {
+        angles[i] = range * (float) i / (float) steps;
+        cos[i] = std::cos(angles[i]);
+        sin[i] = std::sin(angles[i]);
+    }
+}
+
+void PrimitiveMesh::generateWedges(int count, size_t floatsPerWedge,
+                                   const std::function<void(int wedge, VertexWriter& out)>& generateWedge) {
+    size_t offset = m_vertexData.size();
+    m_vertexData.resize(offset + count * floatsPerWedge);
+    auto generateRange = [&](int first, int last) {
+        for (int i = first; i < last; i++) {
+            VertexWriter out{&m_vertexData[offset + i * floatsPerWedge], floatsPerWedge};
+            generateWedge(i, out);
+            assert(out.written == floatsPerWedge && "mesh wedge generated the wrong amount of vertex data");
+        }
+    };
+
+    size_t maxThreads = settings.tessellationThreads > 0 ? (size_t) settings.tessellationThreads
+                                                         : std::max(std::thread::hardware_concurrency(), 1u);
+    int numThreads = (int) std::clamp(count * floatsPerWedge / TESSELLATION_MIN_FLOATS_PER_THREAD, (size_t) 1,
+                                      std::min(maxThreads, (size_t) count));
+    if (numThreads == 1) {
+        generateRange(0, count);
+    } else {
+        // each thread gets a contiguous run of wedges, which is a contiguous range of the vertex data
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back(generateRange, count * t / numThreads, count * (t + 1) / numThreads);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+}
+
 void PrimitiveMesh::allocateBuffers() {
     if (m_glAllocated) {
         std::cerr << "Warning: trying to allocate buffers when already allocated" << std::endl;
@@ -110,39 +236,134 @@ void PrimitiveMesh::allocateBuffers() {
     }
     // generate vao
     glGenVertexArrays(1, &m_vao);
-    // generate vbo
+    // generate vbo and ebo
     glGenBuffers(1, &m_vbo);
-    // bind vbo + vao
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glGenBuffers(1, &m_ebo);
+    // the layout has to be picked before any vao captures it
+    m_vertexFormat = settings.packedVertices && fitsPackedFormat() ? VertexFormat::PACKED : VertexFormat::FLOAT;
+    // bind vao, then set up the attributes from the vbo
     glBindVertexArray(m_vao);
-    // vertex position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)nullptr);
-    glEnableVertexAttribArray(0);
-    // vertex normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // vertex uv attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    bindVertexAttributes();
     // unbind
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     m_glAllocated = true;
 }
 
+void PrimitiveMesh::bindVertexAttributes() const {
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    // the ebo binding is part of the vao's state; it's bound even when the mesh isn't indexed, since glDrawArrays
+    // ignores it, so switching between indexed and non-indexed doesn't need the vaos to be rebuilt
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    if (m_vertexFormat == VertexFormat::PACKED) {
+        // all normalized, so the shader still sees floats; the packed normal type must be given 4 components
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, sizeof(PackedVertex),
+                              (void*)offsetof(PackedVertex, position));
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex),
+                              (void*)offsetof(PackedVertex, normal));
+        glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, uv));
+    } else {
+        // vertex position attribute
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)nullptr);
+        // vertex normal attribute
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(3 * sizeof(float)));
+        // vertex uv attribute
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(6 * sizeof(float)));
+    }
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+}
+
+bool PrimitiveMesh::fitsPackedFormat() const {
+    for (size_t i = 0; i < m_vertexData.size(); i += FLOATS_PER_VERTEX) {
+        for (int j = 0; j < 3; j++) {
+            if (std::abs(m_vertexData[i + j]) > 1.f) {
+                return false;
+            }
+        }
+        for (int j = 6; j < 8; j++) {
+            if (m_vertexData[i + j] < -PACKED_UV_TOLERANCE || m_vertexData[i + j] > 1.f + PACKED_UV_TOLERANCE) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 
 void PrimitiveMesh::updateBuffers() {
     if (m_vertexData.empty()) {
         m_vertexData.reserve(getExpectedVectorSize());
         // can't call this during init for C++ reasons, so this to account for that
         generateVertexData();
+        weldVertices();
     }
     if (!m_glAllocated) {
         allocateBuffers();
     }
+    for (const auto& lod : m_lods) {
+        lod->updateBuffers();
+    }
+    m_buffersIndexed = settings.indexedMeshes;
+    const std::vector<float>& vertices = m_buffersIndexed ? m_indexedVertexData : m_vertexData;
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) (m_vertexData.size() * sizeof(float)), m_vertexData.data(), GL_STATIC_DRAW);
+    if (m_vertexFormat == VertexFormat::PACKED) {
+        if (!fitsPackedFormat()) {
+            std::cerr << "Warning: mesh vertex data no longer fits the packed vertex format, so it will be clamped"
+                      << std::endl;
+        }
+        std::vector<PackedVertex> packed;
+        packed.reserve(vertices.size() / FLOATS_PER_VERTEX);
+        for (size_t i = 0; i < vertices.size(); i += FLOATS_PER_VERTEX) {
+            packed.push_back(packVertex(&vertices[i]));
+        }
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) (packed.size() * sizeof(PackedVertex)), packed.data(),
+                     GL_STATIC_DRAW);
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) (vertices.size() * sizeof(float)), vertices.data(),
+                     GL_STATIC_DRAW);
+    }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // unbind the vao first, or the ebo binding below would change whichever vao is bound
+    glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    if (m_buffersIndexed) {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) (m_indices.size() * sizeof(GLuint)), m_indices.data(),
+                     GL_STATIC_DRAW);
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void PrimitiveMesh::draw() const {
+    if (m_buffersIndexed) {
+        glDrawElements(GL_TRIANGLES, drawCount(true), GL_UNSIGNED_INT, nullptr);
+    } else {
+        glDrawArrays(GL_TRIANGLES, 0, drawCount(false));
+    }
+}
+
+void PrimitiveMesh::drawInstanced(GLsizei instances) const {
+    if (m_buffersIndexed) {
+        glDrawElementsInstanced(GL_TRIANGLES, drawCount(true), GL_UNSIGNED_INT, nullptr, instances);
+    } else {
+        glDrawArraysInstanced(GL_TRIANGLES, 0, drawCount(false), instances);
+    }
+}
+
+GLsizei PrimitiveMesh::drawCount(bool indexed) const {
+    return indexed ? m_indexCount : m_vertexCount;
+}
+
+GLsizei PrimitiveMesh::vertexCount() const {
+    return m_vertexCount;
+}
+
+GLsizei PrimitiveMesh::indexCount() const {
+    return m_indexCount;
 }
 
 void PrimitiveMesh::deleteBuffers() {
@@ -151,8 +372,12 @@ void PrimitiveMesh::deleteBuffers() {
         return;
     }
     glDeleteBuffers(1, &m_vbo);
+    glDeleteBuffers(1, &m_ebo);
     glDeleteVertexArrays(1, &m_vao);
     m_glAllocated = false;
+    for (const auto& lod : m_lods) {
+        lod->deleteBuffers();
+    }
 }
 
 GLuint PrimitiveMesh::vao() const {
@@ -162,6 +387,10 @@ GLuint PrimitiveMesh::vao() const {
     return m_vao;
 }
 
+VertexFormat PrimitiveMesh::vertexFormat() const {
+    return m_vertexFormat;
+}
+
 GLuint PrimitiveMesh::vbo() const {
     if (!m_glAllocated) {
         throw std::runtime_error("Trying to get VBO when not allocated");
@@ -176,4 +405,12 @@ const std::vector<float>& PrimitiveMesh::vertexData() const {
     return m_vertexData;
 }
 
+const std::vector<float>& PrimitiveMesh::indexedVertexData() const {
+    return m_indexedVertexData;
+}
+
+const std::vector<GLuint>& PrimitiveMesh::indices() const {
+    return m_indices;
+}
+
 #pragma clang diagnostic pop
\ No newline at end of file
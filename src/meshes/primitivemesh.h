@@ -4,35 +4,135 @@
 
 #include "glew/include/GL/glew.h"
 #include "glm/glm.hpp"
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <map>
 #include "utils/sceneparser.h"
 #include "aabb.h"
 
 #define FLOATS_PER_VERTEX 8
+/// Number of tessellations per primitive, including the full-detail one; each level halves param1 and param2
+#define LOD_LEVELS 3
+/// Below these projected sizes (see Camera::projectedSize) an object is drawn with LOD level 1 and 2
+#define LOD_LEVEL1_SCREEN_SIZE 0.1f
+#define LOD_LEVEL2_SCREEN_SIZE 0.025f
+/// An object only changes level once its projected size is this fraction past the threshold, so objects sitting right
+/// at a threshold don't flicker between levels
+#define LOD_HYSTERESIS 0.2f
+
+/// Large meshes are tessellated on several threads, each generating at least this many floats of vertex data
+#define TESSELLATION_MIN_FLOATS_PER_THREAD (1 << 16)
+
+/// cos and sin of evenly spaced angles, so tessellation loops can look them up instead of calling glm::cos and
+/// glm::sin for every vertex
+struct AngleTable {
+    AngleTable() = default;
+    /// Tabulates the `steps + 1` angles i * range / steps for i in [0, steps]
+    AngleTable(int steps, float range);
+    std::vector<float> angles;
+    std::vector<float> cos;
+    std::vector<float> sin;
+};
+
+/// Writes vertices into a preallocated range of a mesh's vertex data, so separate parts of the mesh can be generated
+/// concurrently. Writes past the end of the range are dropped (but still counted, so they can be reported)
+struct VertexWriter {
+    float* begin;
+    size_t capacity;
+    size_t written = 0;
+
+    void push(glm::vec3 v, glm::vec3 n, glm::vec2 uv) {
+        if (written + FLOATS_PER_VERTEX <= capacity) {
+            float* out = begin + written;
+            out[0] = v.x;
+            out[1] = v.y;
+            out[2] = v.z;
+            out[3] = n.x;
+            out[4] = n.y;
+            out[5] = n.z;
+            out[6] = uv.x;
+            out[7] = uv.y;
+        }
+        written += FLOATS_PER_VERTEX;
+    }
+};
+
+/// How a mesh's vertices are laid out in its vbo
+enum class VertexFormat {
+    /// FLOATS_PER_VERTEX floats: position, normal, uv
+    FLOAT,
+    /// PackedVertex: snorm16 position, 10_10_10_2 normal, unorm16 uv
+    PACKED
+};
+
+/// Compact vertex for meshes whose positions lie within [-1, 1] and uvs within [0, 1] (the unit primitives), half the
+/// size of the float layout. The normal is GL_INT_2_10_10_10_REV, with x in the low bits
+struct PackedVertex {
+    /// xyz, with w as padding so the normal stays 4-byte aligned
+    int16_t position[4];
+    uint32_t normal;
+    uint16_t uv[2];
+};
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must be tightly packed");
 
 /// Base class for all mesh objects; used to tessellate each primitive shape and generate the respective vertex data
 class PrimitiveMesh {
 public:
-    /// Creates one of each primitive mesh type with the given parameters
+    /// Creates one of each primitive mesh type with the given parameters, and generates their vertex data
+    /// (no GL calls are made; call updateBuffers() once there's a context)
     static std::map<PrimitiveType, std::shared_ptr<PrimitiveMesh>> initMeshes(int param1, int param2);
-    /// Sets the parameters for the mesh and regenerates the vertex data accordingly
+    /// Sets the parameters for the mesh and regenerates the vertex data accordingly (and that of its lower detail levels)
     void setParams(int param1, int param2);
-    /// Sets up vao and vbo (allocating if they have not been already).
-    /// On first call, will also generate the vertex data via generateVertexData();
+    /// Returns the mesh to draw at the given level of detail: the mesh itself for level 0, coarser tessellations of the
+    /// same primitive after that. Meshes without a LOD chain (the skybox) return themselves for every level
+    const PrimitiveMesh& lod(int level) const;
+    /// Number of levels in the LOD chain, including this mesh
+    int lodCount() const;
+    /// Returns the level of detail for an object of the given projected size, without hysteresis
+    static int lodLevelFor(float screenSize);
+    /// Returns the level of detail for an object of the given projected size that is currently drawn at `currentLevel`,
+    /// only switching levels once the size is clearly past a threshold (see LOD_HYSTERESIS)
+    static int selectLOD(float screenSize, int currentLevel);
+    /// Sets up vao and vbo (allocating if they have not been already), for this mesh and its lower detail levels.
+    /// If the vertex data hasn't been generated yet (it normally is in initMeshes), generates it first;
     /// On subsequent calls, it assumes `generateVertexData()` has already been called as of the last `setParams()`
     void updateBuffers();
-    /// Deletes the vao and vbo using glDeleteBuffers and glDeleteVertexArrays
+    /// Deletes the vao, vbo and ebo using glDeleteBuffers and glDeleteVertexArrays
     void deleteBuffers();
     /// Returns the vao of the mesh
     GLuint vao() const;
     /// Returns the vbo of the mesh
     GLuint vbo() const;
-    /// Returns the vertex data of the mesh
+    /// Layout of the vertices in the vbo; chosen when the buffers are first allocated, from settings.packedVertices and
+    /// whether the mesh's data fits in PackedVertex, and fixed after that since instanced vaos capture the layout
+    VertexFormat vertexFormat() const;
+    /// Binds the vbo and ebo and sets up the per-vertex attributes (locations 0-2) on the currently bound vao.
+    /// Used both for the mesh's own vao and for vaos that add per-instance attributes on top
+    void bindVertexAttributes() const;
+    /// Draws the mesh from the currently bound vao (which must have been set up with bindVertexAttributes()), with
+    /// glDrawElements if the buffers hold the indexed mesh and glDrawArrays otherwise
+    void draw() const;
+    /// Same as draw(), but draws `instances` instances
+    void drawInstanced(GLsizei instances) const;
+    /// Number of vertices draw() and drawInstanced() pass to GL, for buffers holding the indexed mesh or not
+    GLsizei drawCount(bool indexed) const;
+    /// Number of vertices in the triangle list (vertexData().size() / FLOATS_PER_VERTEX); cached whenever the vertex data
+    /// is generated, so it's safe to call every draw
+    GLsizei vertexCount() const;
+    /// Number of indices drawn by the indexed path; equal to vertexCount()
+    GLsizei indexCount() const;
+    /// Returns the vertex data of the mesh, as a plain triangle list (3 vertices per triangle, no sharing)
     const std::vector<float>& vertexData() const;
-    /// Computes the AABB of the mesh in world space, given the CTM
-    /// Default implementation uses the mesh bounds; optionally can be overridden in subclasses to use the ideal object bounds
-    virtual AABB computeAABB(const glm::mat4& ctm) const;
+    /// Returns the unique vertices of the mesh, which indices() refers to
+    const std::vector<float>& indexedVertexData() const;
+    /// Returns the triangle list of the mesh as indices into indexedVertexData()
+    const std::vector<GLuint>& indices() const;
+    /// Computes the AABB of the mesh in world space, given the CTM, by transforming localBounds() (see AABB::transformed)
+    AABB computeAABB(const glm::mat4& ctm) const;
+    /// Object-space bounds of the mesh. Default implementation uses the bounds of the vertex data, cached when it's
+    /// generated; overridden in subclasses to use the ideal object bounds
+    virtual AABB localBounds() const;
 protected:
     /// Generic constructor for a primitive mesh; called by subclasses' constructors
     PrimitiveMesh(int param1, int param2);
@@ -55,14 +155,36 @@ protected:
     bool glAllocated() const;
     /// Pushes a vertex and normal to the vertex data vector
     void pushVertex(glm::vec3 v, glm::vec3 n, glm::vec2 uv);
+    /// Appends `count` wedges of exactly `floatsPerWedge` floats each to the vertex data, in order, by calling
+    /// generateWedge(i, writer) for each. Large meshes split the wedges across threads, so generateWedge must only
+    /// read the mesh. Writes past a wedge are dropped by VertexWriter, and debug builds assert that each wedge writes
+    /// exactly floatsPerWedge (mesh_counts_test checks the resulting data)
+    void generateWedges(int count, size_t floatsPerWedge,
+                        const std::function<void(int wedge, VertexWriter& out)>& generateWedge);
     std::vector<float> m_vertexData;
 private:
-    /// Allocates the vao and vbo, and sets up the attributes in the vao
+    /// Allocates the vao, vbo and ebo, and sets up the attributes in the vao
     void allocateBuffers();
+    /// Builds m_indexedVertexData and m_indices from m_vertexData by merging bit-identical vertices, and caches the counts
+    /// and the bounds of the vertices
+    void weldVertices();
+    /// Returns whether every vertex of the mesh can be stored as a PackedVertex without clamping
+    bool fitsPackedFormat() const;
     bool m_glAllocated = false;
     int m_param1;
     int m_param2;
     GLuint m_vao;
     GLuint m_vbo;
+    GLuint m_ebo;
+    std::vector<float> m_indexedVertexData;
+    std::vector<GLuint> m_indices;
+    GLsizei m_vertexCount = 0;
+    GLsizei m_indexCount = 0;
+    AABB m_vertexBounds{glm::vec3(0.f), glm::vec3(0.f)};
+    /// Levels 1 and up of the LOD chain; empty for the lower levels themselves
+    std::vector<std::shared_ptr<PrimitiveMesh>> m_lods;
+    /// Whether the buffers hold the indexed mesh (see settings.indexedMeshes); set by updateBuffers()
+    bool m_buffersIndexed = false;
+    VertexFormat m_vertexFormat = VertexFormat::FLOAT;
 };
 #pragma clang diagnostic pop
\ No newline at end of file
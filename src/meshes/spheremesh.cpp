@@ -4,87 +4,68 @@
 
 SphereMesh::SphereMesh(int param1, int param2) : PrimitiveMesh(param1, param2) {}
 
+AABB SphereMesh::localBounds() const {
+    return {glm::vec3(-0.5f), glm::vec3(0.5f)};
+}
+
 void SphereMesh::generateVertexData() {
-    float thetaStep = glm::radians(360.f / (float) param2());
-    float currentTheta = 0 * thetaStep;
-    float nextTheta = 1 * thetaStep;
-    for (int i = 0; i < param2(); i++) {
+    m_thetas = AngleTable(param2(), 2 * glm::pi<float>());
+    m_phis = AngleTable(param1(), glm::pi<float>());
+    // two tip triangles and param1 - 2 tiles of two triangles each
+    size_t floatsPerWedge = (2 + 2 * std::max(param1() - 2, 0)) * 3 * FLOATS_PER_VERTEX;
+    generateWedges(param2(), floatsPerWedge, [this](int i, VertexWriter& out) {
         // why did i have to swap currentTheta and nextTheta? that doesn't make sense...
         //    edit: looks like theta is moving clockwise??? for some reason???
-        makeWedge(nextTheta, currentTheta);
-        currentTheta += thetaStep;
-        nextTheta += thetaStep;
-    }
+        makeWedge(out, i + 1, i);
+    });
 }
 
-void SphereMesh::makeTopTipTile(glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta) {
-    pushVertex(center, glm::normalize(center), getUV(center, (leftTheta + rightTheta) / 2));
-    pushVertex(bottomLeft, glm::normalize(bottomLeft), getUV(bottomLeft, leftTheta));
-    pushVertex(bottomRight, glm::normalize(bottomRight), getUV(bottomRight, rightTheta));
+glm::vec3 SphereMesh::getPosition(int phi, int theta) const {
+    // x = r * sin(phi) * cos(theta)
+    // y = r * cos(phi)
+    // z = r * sin(phi) * sin(theta)
+    float r = 0.5;
+    return {r * m_phis.sin[phi] * m_thetas.cos[theta], r * m_phis.cos[phi], r * m_phis.sin[phi] * m_thetas.sin[theta]};
 }
 
-void SphereMesh::makeBottomTipTile(glm::vec3 center, glm::vec3 topLeft, glm::vec3 topRight, float leftTheta, float rightTheta) {
-    pushVertex(center, glm::normalize(center), getUV(center, (leftTheta + rightTheta) / 2));
-    pushVertex(topRight, glm::normalize(topRight), getUV(topRight, rightTheta));
-    pushVertex(topLeft, glm::normalize(topLeft), getUV(topLeft, leftTheta));
+void SphereMesh::pushSphereVertex(VertexWriter& out, int phi, int theta) const {
+    glm::vec3 position = getPosition(phi, theta);
+    // sphere normal is just direction from origin
+    out.push(position, position * 2.f, getUV(m_phis.angles[phi], m_thetas.angles[theta]));
 }
 
-void SphereMesh::makeTile(glm::vec3 topLeft,
-                      glm::vec3 topRight,
-                      glm::vec3 bottomLeft,
-                      glm::vec3 bottomRight,
-                      float leftTheta,
-                      float rightTheta) {
-    pushVertex(topLeft, glm::normalize(topLeft), getUV(topLeft, leftTheta)); // sphere normal is just direction from origin
-    pushVertex(bottomRight, glm::normalize(bottomRight), getUV(bottomRight, rightTheta));
-    pushVertex(topRight, glm::normalize(topRight), getUV(topRight, rightTheta));
-
-    pushVertex(topLeft, glm::normalize(topLeft), getUV(topLeft, leftTheta));
-    pushVertex(bottomLeft, glm::normalize(bottomLeft), getUV(bottomLeft, leftTheta));
-    pushVertex(bottomRight, glm::normalize(bottomRight), getUV(bottomRight, rightTheta));
+void SphereMesh::makeTopTipTile(VertexWriter& out, int leftTheta, int rightTheta) const {
+    float middleTheta = (m_thetas.angles[leftTheta] + m_thetas.angles[rightTheta]) / 2;
+    out.push(glm::vec3(0, 0.5, 0), glm::vec3(0, 1, 0), getUV(0, middleTheta));
+    pushSphereVertex(out, 1, leftTheta);
+    pushSphereVertex(out, 1, rightTheta);
 }
 
-void SphereMesh::makeWedge(float currentTheta, float nextTheta) {
-    float phiStep = glm::radians(180.f / (float) param1());
-    float currentPhi = 0 * phiStep;
-    float nextPhi = 1 * phiStep;
-    float r = 0.5;
-    // x = r * sin(phi) * cos(theta)
-    // y = r * cos(phi)
-    // z = r * sin(phi) * sin(theta)
-    for (int i = 0; i < param1(); i++) {
-        glm::vec3 topLeft = glm::vec3(
-                r * glm::sin(currentPhi) * glm::cos(currentTheta),
-                r * glm::cos(currentPhi),
-                r * glm::sin(currentPhi) * glm::sin(currentTheta)
-        );
-        glm::vec3 topRight = glm::vec3(
-                r * glm::sin(currentPhi) * glm::cos(nextTheta),
-                r * glm::cos(currentPhi),
-                r * glm::sin(currentPhi) * glm::sin(nextTheta)
-        );
-        glm::vec3 bottomLeft = glm::vec3(
-                r * glm::sin(nextPhi) * glm::cos(currentTheta),
-                r * glm::cos(nextPhi),
-                r * glm::sin(nextPhi) * glm::sin(currentTheta)
-        );
-        glm::vec3 bottomRight = glm::vec3(
-                r * glm::sin(nextPhi) * glm::cos(nextTheta),
-                r * glm::cos(nextPhi),
-                r * glm::sin(nextPhi) * glm::sin(nextTheta)
-        );
-        if (i == 0) {
-            glm::vec3 center = glm::vec3(0, 0.5, 0);
-            makeTopTipTile(center, bottomLeft, bottomRight, currentTheta, nextTheta);
-        } else if (i == param1() - 1) {
-            glm::vec3 center = glm::vec3(0, -0.5, 0);
-            makeBottomTipTile(center, topLeft, topRight, currentTheta, nextTheta);
-        } else {
-            makeTile(topLeft, topRight, bottomLeft, bottomRight, currentTheta, nextTheta);
-        }
-        currentPhi += phiStep;
-        nextPhi += phiStep;
+void SphereMesh::makeBottomTipTile(VertexWriter& out, int leftTheta, int rightTheta) const {
+    float middleTheta = (m_thetas.angles[leftTheta] + m_thetas.angles[rightTheta]) / 2;
+    int top = param1() - 1;
+    out.push(glm::vec3(0, -0.5, 0), glm::vec3(0, -1, 0), getUV(glm::pi<float>(), middleTheta));
+    pushSphereVertex(out, top, rightTheta);
+    pushSphereVertex(out, top, leftTheta);
+}
+
+void SphereMesh::makeTile(VertexWriter& out, int topPhi, int leftTheta, int rightTheta) const {
+    int bottomPhi = topPhi + 1;
+    pushSphereVertex(out, topPhi, leftTheta);
+    pushSphereVertex(out, bottomPhi, rightTheta);
+    pushSphereVertex(out, topPhi, rightTheta);
+
+    pushSphereVertex(out, topPhi, leftTheta);
+    pushSphereVertex(out, bottomPhi, leftTheta);
+    pushSphereVertex(out, bottomPhi, rightTheta);
+}
+
+void SphereMesh::makeWedge(VertexWriter& out, int currentTheta, int nextTheta) const {
+    makeTopTipTile(out, currentTheta, nextTheta);
+    for (int i = 1; i < param1() - 1; i++) {
+        makeTile(out, i, currentTheta, nextTheta);
     }
+    makeBottomTipTile(out, currentTheta, nextTheta);
 }
 
 int SphereMesh::getMinParam1() const {
@@ -107,11 +88,9 @@ int SphereMesh::getExpectedVectorSize() {
         * FLOATS_PER_VERTEX; // number of floats per vertex
 }
 
-glm::vec2 SphereMesh::getUV(glm::vec3 pos, float theta) {
-    // from lecture: phi = asin(y/r) = asin(2y) => phi in range [-pi/2, pi/2]
-    // v = phi/2 + 1/2
-    float asin = std::asin(2.f * pos.y);
-    float v = asin /  glm::pi<float>() + 0.5f;
+glm::vec2 SphereMesh::getUV(float phi, float theta) {
+    // from lecture: v = asin(y / r) / pi + 1/2, and asin(y / r) = asin(cos(phi)) = pi/2 - phi
+    float v = 1 - phi / glm::pi<float>();
     // for some reason we need a 1 - theta / (2 * M_PIf) here instead of theta / (2 * M_PIf)???  idk why
     float u = 1 - theta / (2 *  glm::pi<float>());
 
@@ -6,22 +6,27 @@
 class SphereMesh : public PrimitiveMesh {
 public:
     SphereMesh(int param1, int param2);
+    /// The ideal sphere just touches every face of the unit cube, whatever the tessellation
+    AABB localBounds() const override;
 protected:
     int getMinParam1() const override;
     int getMinParam2() const override;
     int getExpectedVectorSize() override;
     void generateVertexData() override;
 private:
-    static glm::vec2 getUV(glm::vec3 pos, float theta);
-    void makeTopTipTile(glm::vec3 center, glm::vec3 bottomLeft, glm::vec3 bottomRight, float leftTheta, float rightTheta);
-    void makeBottomTipTile(glm::vec3 center, glm::vec3 topLeft, glm::vec3 topRight, float leftTheta, float rightTheta);
-    void makeTile(glm::vec3 topLeft,
-                  glm::vec3 topRight,
-                  glm::vec3 bottomLeft,
-                  glm::vec3 bottomRight,
-                  float leftTheta,
-                  float rightTheta);
-    void makeWedge(float currTheta, float nextTheta);
+    /// v of the uv is computed from phi directly, rather than from the position with an asin
+    static glm::vec2 getUV(float phi, float theta);
+    /// Position of the vertex at the given indices into m_phis and m_thetas
+    glm::vec3 getPosition(int phi, int theta) const;
+    void pushSphereVertex(VertexWriter& out, int phi, int theta) const;
+    // the tiles and wedges take indices into m_phis and m_thetas
+    void makeTopTipTile(VertexWriter& out, int leftTheta, int rightTheta) const;
+    void makeBottomTipTile(VertexWriter& out, int leftTheta, int rightTheta) const;
+    void makeTile(VertexWriter& out, int topPhi, int leftTheta, int rightTheta) const;
+    void makeWedge(VertexWriter& out, int currentTheta, int nextTheta) const;
+    /// Longitude and colatitude of each wedge and ring boundary; rebuilt whenever the vertex data is generated
+    AngleTable m_thetas;
+    AngleTable m_phis;
 };
 
 
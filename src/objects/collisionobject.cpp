@@ -6,7 +6,20 @@
 CollisionObject::CollisionObject(const RenderShapeData& data,
                                  const std::shared_ptr<RealtimeScene>& scene)
         : super(data, scene) {
-    m_aabb = mesh()->computeAABB(CTM());
+    setAABB(mesh()->computeAABB(CTM()));
+}
+
+CollisionObject::CollisionObject(const RenderShapeData& data,
+                                 const std::shared_ptr<RealtimeScene>& scene, const AABB& aabb)
+        : super(data, scene) {
+    setAABB(aabb);
+}
+
+CollisionObject::~CollisionObject() {
+    // the scene is already gone if we're being destroyed as part of the scene's destructor
+    if (auto currentScene = scene()) {
+        currentScene->collisionGrid().remove(this);
+    }
 }
 
 
@@ -23,26 +36,34 @@ glm::vec3 CollisionObject::translateAndCollide(const glm::vec3& translation) {
 }
 
 void CollisionObject::translate(const glm::vec3& translation) {
+    // also moves the AABB, since it's the entity's bounds
     super::translate(translation);
-    m_aabb.translate(translation);
+    if (auto currentScene = scene()) {
+        currentScene->collisionGrid().update(this);
+    }
 }
 
 std::optional<CollisionInfo> CollisionObject::getCollisionInfo(const glm::vec3& targetTranslation, int passes) const {
     if (passes <= 0) {
         return std::nullopt;
     }
+    auto currentScene = scene();
+    if (!currentScene) {
+        return std::nullopt;
+    }
+    // reused between calls so the broadphase doesn't allocate every time; cleared before returning so we never keep
+    // objects alive longer than the scene does
+    static thread_local std::vector<std::shared_ptr<CollisionObject>> candidates;
     std::set<std::shared_ptr<CollisionObject>> collidedObjects;
     glm::vec3 totalCorrectionVec = glm::vec3(0.f);
-    AABB movedAABB = m_aabb;
+    AABB movedAABB = aabb();
     movedAABB.translate(targetTranslation);
     for (int passesLeft = passes; passesLeft > 0; passesLeft--) {
         bool collisionThisPass = false;
-        for (const auto& objectWeak : scene()->collisionObjects()) {
-            auto object = objectWeak.lock();
-            if (!object) {
-                // if the weak_ptr has expired, it's fine; it'll get deleted by the main tick loop later
-                continue;
-            }
+        // only objects in the grid cells overlapped by the moved AABB can possibly collide with it
+        candidates.clear();
+        currentScene->collisionGrid().query(movedAABB, candidates);
+        for (const auto& object : candidates) {
             if (object.get() == this) {
                 continue;
             }
@@ -68,6 +89,7 @@ std::optional<CollisionInfo> CollisionObject::getCollisionInfo(const glm::vec3&
 
         }
     }
+    candidates.clear();
     if (collidedObjects.empty()) {
         return std::nullopt;
     } else {
@@ -77,7 +99,12 @@ std::optional<CollisionInfo> CollisionObject::getCollisionInfo(const glm::vec3&
 
 
 const AABB& CollisionObject::aabb() const {
-    return m_aabb;
+    return entities().bounds(entity());
+}
+
+void CollisionObject::setAABB(const AABB& aabb) {
+    entities().bounds(entity()) = aabb;
+    entities().flags(entity()) |= ENTITY_BOUNDS_VALID;
 }
 
 
@@ -32,11 +32,18 @@ public:
     void setCollisionFilter(std::function<bool(std::shared_ptr<CollisionObject>)> filter);
     std::optional<std::function<bool(std::shared_ptr<CollisionObject>)>> collisionFilter() const;
 
+    /// The collision AABB, which doubles as the culling bounding box (same as boundingBox())
     const AABB& aabb() const;
+
+    /// Unregisters the object from the scene's collision grid
+    ~CollisionObject() override;
 protected:
     CollisionObject(const RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene);
+    /// Uses an AABB that was already computed (e.g. by CityChunkGenerator), instead of computing it from the mesh
+    CollisionObject(const RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene, const AABB& aabb);
 private:
-    AABB m_aabb;
+    /// Stores the AABB as the entity's bounds
+    void setAABB(const AABB& aabb);
     /// Function that filters which objects this object can collide with. If empty, collides with all objects.
     /// The given function should return true if the object should collide with the given object, and false otherwise.
     std::optional<std::function<bool(std::shared_ptr<CollisionObject>)>> m_collisionFilter = std::nullopt;
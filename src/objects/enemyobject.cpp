@@ -14,6 +14,19 @@
 #include "material_constants/enemy_materials.h"
 
 
+namespace {
+    // looked up once, so switching materials every tick is just an integer store
+    MaterialID normalMaterial() {
+        static const MaterialID id = MaterialRegistry::global().intern(enemy_materials::enemyMaterial1);
+        return id;
+    }
+
+    MaterialID damagedMaterial() {
+        static const MaterialID id = MaterialRegistry::global().intern(enemy_materials::damagedEnemyMaterial1);
+        return id;
+    }
+}
+
 EnemyObject::EnemyObject(RenderShapeData& data,
                          const std::shared_ptr<RealtimeScene>& scene,
                          std::shared_ptr<Camera> camera, std::shared_ptr<bool> taken_damage)
@@ -23,29 +36,21 @@ EnemyObject::EnemyObject(RenderShapeData& data,
     // enemy should render by default
     m_camera = std::move(camera);
     setShouldRender(true);
+    entities().setSystem(entity(), EntitySystem::SEEK_TARGET);
 }
 
 void EnemyObject::translate(const glm::vec3& translation) {
     super::translate(translation);
 }
 
-void EnemyObject::tick(double elapsedSeconds) {
-    //determine where the player is relative to the enemy.
-    //does not take into account the y component.
-    glm::vec3 direction_to_player = glm::normalize(glm::vec3(m_camera->pos().x, 0.f, m_camera->pos().z)
-                                                   - glm::vec3(pos().x, 0.f, pos().z));
-
-    //if enemy is more than 50 away despawn
-    if (glm::length(glm::vec3(m_camera->pos().x, 0.f, m_camera->pos().z)
-                                                   - glm::vec3(pos().x, 0.f, pos().z)) > 50)
-    {
-        queueFree();
-    }
-
-    glm::vec3 enemy2DVelocity = direction_to_player * ENEMY_SPEED;
-    m_velocity.x = enemy2DVelocity.x;
-    m_velocity.z = enemy2DVelocity.z;
+bool EnemyObject::hasTick() const {
+    return true;
+}
 
+void EnemyObject::tick(double elapsedSeconds) {
+    // the horizontal velocity (towards the player) and despawning when too far away are handled by
+    // EntityStore::seekTarget for every enemy at once, before the objects are ticked
+    glm::vec3& velocity = entities().velocity(entity());
 
     // Basic physics/collision; COPIED FROM playerobject.cpp!!!
 
@@ -56,11 +61,11 @@ void EnemyObject::tick(double elapsedSeconds) {
 
 
     if (!m_onGround) {
-        m_velocity.y -= m_gravity * deltaTime;
+        velocity.y -= m_gravity * deltaTime;
     }
-    // std::cout << glm::to_string(m_velocity) << std::endl;
+    // std::cout << glm::to_string(velocity) << std::endl;
 
-    glm::vec3 translation = m_velocity * deltaTime;
+    glm::vec3 translation = velocity * deltaTime;
     auto collisionInfoOpt = getCollisionInfo(translation);
 
     // reset velocity in direction of collision
@@ -69,8 +74,8 @@ void EnemyObject::tick(double elapsedSeconds) {
     if (collisionInfoOpt.has_value()) {
         glm::vec3 collisionMovementDir = collisionInfoOpt->collisionCorrectionVec;
         glm::vec3 projOfVelOnCollisionMovementDir =
-                m_velocity * (glm::dot(glm::normalize(m_velocity), collisionMovementDir));
-        m_velocity += projOfVelOnCollisionMovementDir;
+                velocity * (glm::dot(glm::normalize(velocity), collisionMovementDir));
+        velocity += projOfVelOnCollisionMovementDir;
         if (collisionMovementDir.y > 0.f) {
             m_onGround = true;
         }
@@ -92,7 +97,7 @@ void EnemyObject::tick(double elapsedSeconds) {
 
     //reset the way that the damaged enemies look
     if (std::chrono::steady_clock::now() > damage_end_time && health > 0) {
-        setMaterial(enemy_materials::enemyMaterial1);
+        setMaterial(normalMaterial());
     }
 
     translate(translation);
@@ -107,7 +112,7 @@ void EnemyObject::onShot() {
         return;
     }
     damage_end_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(ON_ENEMY_HIT_FLASH_MS);
-    setMaterial(enemy_materials::damagedEnemyMaterial1);
+    setMaterial(damagedMaterial());
 }
 
 #pragma clang diagnostic pop
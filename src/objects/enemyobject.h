@@ -5,17 +5,22 @@
 #include "camera.h"
 
 // TODO play with defaults
-#define DEFAULT_ENEMY_GRAVITY 15.f
-#define ENEMY_SPEED 2.f
+// doubled (speed) and quadrupled (gravity) along with the player's constants (see playerobject.h)
+#define DEFAULT_ENEMY_GRAVITY 60.f
+#define ENEMY_SPEED 4.f
 #define EPSILON 0.0001f
 #define HEALTH 3
 #define ON_ENEMY_HIT_FLASH_MS 300
+// enemies farther than this from the player (horizontally) despawn
+#define ENEMY_DESPAWN_DISTANCE 50.f
 
+/// Steered towards the player by EntityStore::seekTarget; its own tick applies gravity and collision
 class EnemyObject : public CollisionObject {
 public:
     EnemyObject(RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene,
                  std::shared_ptr<Camera> camera, std::shared_ptr<bool> taken_damage);
     void tick(double elapsedSeconds) override;
+    bool hasTick() const override;
     void onShot();
     /// Moves the enemy
     void translate(const glm::vec3& translation) override;
@@ -25,7 +30,6 @@ private:
     int health = HEALTH;
     std::shared_ptr<Camera> m_camera;
     float m_gravity = DEFAULT_ENEMY_GRAVITY;
-    glm::vec3 m_velocity = glm::vec3(0.f);
     bool m_onGround = false;
     RenderShapeData& m_renderShapeData;
 
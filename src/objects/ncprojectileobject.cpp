@@ -11,30 +11,11 @@ NCProjectileObject::NCProjectileObject(const RenderShapeData& data,
                                    const glm::vec3& direction,
                                    float speed,
                                    float maxDistance)
-        : super(data, scene),
-          m_direction(glm::normalize(direction)),
-          m_speed(speed),
-          m_traveledDistance(0.f),
-          m_maxDistance(maxDistance)
+        : super(data, scene)
 {
     setShouldRender(true);
+    entities().velocity(entity()) = glm::normalize(direction) * speed;
+    // destroyed once it has traveled maxDistance
+    entities().range(entity()) = maxDistance;
+    entities().setSystem(entity(), EntitySystem::LINEAR_MOTION);
 }
-
-void NCProjectileObject::tick(double elapsedSeconds) {
-    // Calculate the translation vector for this tick
-    glm::vec3 translation = m_direction * m_speed * (float)elapsedSeconds;
-
-
-    // Move the projectile
-    translate(translation);
-
-    // Update the distance traveled
-    m_traveledDistance += glm::length(translation);
-
-    // Destroy the projectile if it exceeds max distance
-    if (m_traveledDistance >= m_maxDistance) {
-        queueFree();
-    }
-
-}
-
@@ -3,6 +3,7 @@
 #include "realtimeobject.h"
 #include <memory>
 
+/// Projectile without collision; moved by EntityStore::integrateLinearMotion rather than its own tick
 class NCProjectileObject : public RealtimeObject {
 public:
     NCProjectileObject(const RenderShapeData& data,
@@ -10,13 +11,6 @@ public:
                      const glm::vec3& direction,
                      float speed,
                      float maxDistance);
-
-    void tick(double elapsedSeconds) override;
 private:
-    glm::vec3 m_direction;      // Unit direction vector for projectile movement
-    float m_speed;              // Speed of the projectile
-    float m_traveledDistance;   // Distance traveled by the projectile
-    float m_maxDistance;        // Maximum distance the projectile can travel before being destroyed
-
     typedef RealtimeObject super;
 };
@@ -8,6 +8,7 @@
 #include "playerobject.h"
 #include "realtimescene.h"
 #include "projectileobject.h"
+#include "staticobject.h"
 #include "utils/helpers.h"
 
 
@@ -34,6 +35,10 @@ void PlayerObject::translate(const glm::vec3& translation) {
     m_camera->translate(translation);
 }
 
+bool PlayerObject::hasTick() const {
+    return true;
+}
+
 void PlayerObject::tick(double elapsedSeconds) {
     super::tick(elapsedSeconds);
 
@@ -99,9 +104,12 @@ void PlayerObject::tick(double elapsedSeconds) {
     if (m_keyMap[GLFW_KEY_E]) {
         m_keyMap[GLFW_KEY_E] = false;
 
-        scene()->addObject(PrimitiveType::PRIMITIVE_CONE, glm::translate(glm::mat4(1.f), m_camera->pos() + 2.f * m_camera->look()),
-                           SceneMaterial{SceneColor{0.1f, 0.1f, 0.1f, 1.f}, SceneColor{1.f, 1.f, 1.f, 1.f}},
-                           RealtimeObjectType::STATIC);
+        glm::mat4 coneCTM = glm::translate(glm::mat4(1.f), m_camera->pos() + 2.f * m_camera->look());
+        scene()->commands().spawn([coneCTM](const std::shared_ptr<RealtimeScene>& scene) {
+            ScenePrimitive conePrimitive{PrimitiveType::PRIMITIVE_CONE,
+                                         SceneMaterial{SceneColor{0.1f, 0.1f, 0.1f, 1.f}, SceneColor{1.f, 1.f, 1.f, 1.f}}};
+            return std::make_unique<StaticObject>(RenderShapeData{conePrimitive, coneCTM}, scene);
+        });
 
     }
     // example usage of removing object from scene
@@ -110,7 +118,7 @@ void PlayerObject::tick(double elapsedSeconds) {
         auto collisionInfoLookOpt = getCollisionInfo(m_camera->look());
         if (collisionInfoLookOpt.has_value()) {
             m_keyMap[GLFW_KEY_R] = false;
-            (*collisionInfoLookOpt->objects.begin())->queueFree();
+            scene()->commands().free(*collisionInfoLookOpt->objects.begin());
         }
     }
 
@@ -159,7 +167,7 @@ void PlayerObject::spawnBullet() {
                                        SceneMaterial{SceneColor{0.1f, 0.1f, 0.1f, 1.f}, SceneColor{1.f, 1.f, 1.f, 1.f}}};
 
     projectilePrimitive.material.textureMap.isUsed = true;;
-    projectilePrimitive.material.textureMap.filename = "scenefiles/moretextures/green_halo.jpg";
+    projectilePrimitive.material.textureMap.filename = PROJECTILE_TEXTURE;
     projectilePrimitive.material.textureMap.repeatU = 1.0f;  // Set U repeat value
     projectilePrimitive.material.textureMap.repeatV = 1.0f;  // Set V repeat value
 
@@ -172,9 +180,11 @@ void PlayerObject::spawnBullet() {
 
     RenderShapeData projectileData{projectilePrimitive, projectileCTM};
 
-    // Add projectile to the scene
-    scene()->addObject(std::make_unique<ProjectileObject>(
-            projectileData, scene(), direction, 10.f, 50.f, true)); // Speed: 10, Max Distance: 50
+    // Add projectile to the scene once the objects are done ticking
+    scene()->commands().spawn([projectileData, direction](const std::shared_ptr<RealtimeScene>& scene) {
+        return std::make_unique<ProjectileObject>(projectileData, scene, direction, PLAYER_PROJECTILE_SPEED,
+                                                  PLAYER_PROJECTILE_RANGE, true);
+    });
 }
 
 void PlayerObject::keyPressEvent(int key) {
@@ -5,21 +5,27 @@
 #include "camera.h"
 
 // TODO play with defaults
-#define DEFAULT_PLAYER_GRAVITY 10.f
-#define PLAYER_TERMINAL_VELOCITY 100.f
-#define PLAYER_MOVE_ACCEL 20.f
-#define PLAYER_MAX_HORIZ_SPEED 5.f
-#define PLAYER_FRICTION_ACCEL 30.f
-#define PLAYER_JUMP_SPEED 150.f
+// speeds (units/s) and accelerations (units/s^2) were doubled and quadrupled respectively when
+// objects stopped being ticked twice per step, so the game plays the same
+#define DEFAULT_PLAYER_GRAVITY 40.f
+#define PLAYER_TERMINAL_VELOCITY 200.f
+#define PLAYER_MOVE_ACCEL 80.f
+#define PLAYER_MAX_HORIZ_SPEED 10.f
+#define PLAYER_FRICTION_ACCEL 120.f
+#define PLAYER_JUMP_SPEED 600.f
 #define ROTATE_SENSITIVITY 0.005f
 #define EPSILON 0.0001f
 #define PLAYER_MOVE_ACCEL_WITH_FRICTION (PLAYER_MOVE_ACCEL + PLAYER_FRICTION_ACCEL)
+#define PROJECTILE_TEXTURE "scenefiles/moretextures/green_halo.jpg"
+#define PLAYER_PROJECTILE_SPEED 20.f
+#define PLAYER_PROJECTILE_RANGE 50.f
 
 class PlayerObject : public CollisionObject {
 public:
     PlayerObject(const RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene,
                  std::shared_ptr<Camera> camera, std::shared_ptr<std::vector<SceneLightData>> lights);
     void tick(double elapsedSeconds) override;
+    bool hasTick() const override;
     /// Moves the player and camera
     void translate(const glm::vec3& translation) override;
     // input events methods; currently called manually by realtimescene;
@@ -5,7 +5,6 @@
 #include <glm/gtx/transform.hpp>
 
 #include "realtimescene.h"
-#include "ncprojectileobject.h"
 #include "enemyobject.h"
 
 ProjectileObject::ProjectileObject(const RenderShapeData& data,
@@ -15,13 +14,11 @@ ProjectileObject::ProjectileObject(const RenderShapeData& data,
                                    float maxDistance,
                                    bool isBullet)
         : super(data, scene),
-          m_direction(glm::normalize(direction)),
-          m_speed(speed),
-          m_traveledDistance(0.f),
-          m_maxDistance(maxDistance),
           m_isBullet(isBullet)
 {
     setShouldRender(true);
+    entities().velocity(entity()) = glm::normalize(direction) * speed;
+    entities().range(entity()) = maxDistance;
     setCollisionFilter([](std::shared_ptr<CollisionObject> object) {
         // Don't collide with the player
         if (std::dynamic_pointer_cast<PlayerObject>(object)) {
@@ -32,9 +29,13 @@ ProjectileObject::ProjectileObject(const RenderShapeData& data,
     });
 }
 
+bool ProjectileObject::hasTick() const {
+    return true;
+}
+
 void ProjectileObject::tick(double elapsedSeconds) {
     // Calculate the translation vector for this tick
-    glm::vec3 translation = m_direction * m_speed * (float)elapsedSeconds;
+    glm::vec3 translation = entities().velocity(entity()) * (float)elapsedSeconds;
 
     // Check for collisions
     auto collisionInfo = getCollisionInfo(translation);
@@ -57,11 +58,12 @@ void ProjectileObject::tick(double elapsedSeconds) {
     // Move the projectile
     translate(translation);
 
-    // Update the distance traveled
-    m_traveledDistance += glm::length(translation);
+    // Update the distance left to travel
+    float& range = entities().range(entity());
+    range -= glm::length(translation);
 
     // Destroy the projectile if it exceeds max distance
-    if (m_traveledDistance >= m_maxDistance) {
+    if (range <= 0.f) {
         queueFree();
     }
 
@@ -69,32 +71,13 @@ void ProjectileObject::tick(double elapsedSeconds) {
 
 void ProjectileObject::collisionSphereEffect()
 {
-    int numProjectiles = 500; // Number of projectiles to spawn
-    float speed = 5.0f;     // Speed of the additional projectiles
-    float maxDistance = 1.0f; // Max distance for the spawned projectiles
-    // std::cout << "ENtering sphere effect" << std::endl;
-    for (int i = 0; i < numProjectiles; ++i) {
-        // Generate a random direction for the new projectile
-        glm::vec3 randomDirection = glm::normalize(glm::vec3(
-            static_cast<float>(rand()) / RAND_MAX * 2.0f - 1.0f,
-            static_cast<float>(rand()) / RAND_MAX * 2.0f - 1.0f,
-            static_cast<float>(rand()) / RAND_MAX * 2.0f - 1.0f
-        ));
-
-        // Create render shape data for the projectile
-        ScenePrimitive projectilePrimitive{PrimitiveType::PRIMITIVE_SPHERE,
-            SceneMaterial{SceneColor{0.1f, 0.1f, 0.1f, 1.f}, SceneColor{1.f, 1.f, 1.f, 1.f}}};
-        glm::mat4 projectileCTM = this->CTM();
-        projectileCTM = glm::scale(projectileCTM, glm::vec3(0.1f)); // Smaller spheres
-        projectileCTM = glm::translate(projectileCTM, randomDirection);
-
-        RenderShapeData projectileData{projectilePrimitive, projectileCTM};
-
-        // Add the new projectile to the scene
-        scene()->addObject(std::make_unique<NCProjectileObject>(
-            projectileData, scene(), randomDirection, speed, maxDistance));
-        // scene()->addObject(std::make_unique<CollisionObject>(
-        //     projectileData, scene()));
-    }
+    // the sparks are a tenth of the size of the projectile and fly out from its center
+    float projectileScale = glm::length(glm::vec3(CTM()[0]));
+    scene()->particles().emitBurst(ParticleBurst{
+        glm::vec3(CTM()[3]),
+        IMPACT_SPARK_COUNT,
+        IMPACT_SPARK_SPEED,
+        IMPACT_SPARK_LIFETIME,
+        0.1f * projectileScale
+    });
 }
-
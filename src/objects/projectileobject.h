@@ -3,6 +3,12 @@
  #include "collisionobject.h"
  #include <memory>
 
+ // the burst of sparks on impact, in units/s and seconds of the same dt as the retuned movement constants in
+ // playerobject.h; the sparks cover 1 unit at the pace of the spark objects they replaced
+ #define IMPACT_SPARK_COUNT 500
+ #define IMPACT_SPARK_SPEED 10.f
+ #define IMPACT_SPARK_LIFETIME 0.1f
+
  class ProjectileObject : public CollisionObject {
  public:
      ProjectileObject(const RenderShapeData& data,
@@ -13,12 +19,10 @@
                       bool isBullet);
 
      void tick(double elapsedSeconds) override;
+     bool hasTick() const override;
      void collisionSphereEffect();
  private:
-     glm::vec3 m_direction;      // Unit direction vector for projectile movement
-     float m_speed;              // Speed of the projectile
-     float m_traveledDistance;   // Distance traveled by the projectile
-     float m_maxDistance;        // Maximum distance the projectile can travel before being destroyed
+     // the velocity (direction * speed) and the distance left before being destroyed live in the EntityStore
      float m_isBullet;
 
      typedef CollisionObject super;
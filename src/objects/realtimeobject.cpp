@@ -2,79 +2,123 @@
 #include "realtimeobject.h"
 #include "realtimescene.h"
 
-std::map<std::string, std::shared_ptr<Image>> textureCache;
-
 RealtimeObject::RealtimeObject(const RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene) :
-m_mesh(scene->meshes().at(data.primitive.type)), m_ctm(data.ctm),
-m_inverseOfTranspose3x3CTM(glm::inverse(glm::transpose(glm::mat3(data.ctm)))),
-m_material(data.primitive.material), m_type(data.primitive.type), m_shouldRender(true), m_scene(std::weak_ptr(scene)),
-m_queuedFree(false) {
-    if (m_material.textureMap.isUsed) {
-        if (m_material.blend < 0 || m_material.blend > 1) {
+m_scene(std::weak_ptr(scene)), m_entities(scene->entities()), m_entity(m_entities->create(this, data.ctm)),
+m_mesh(scene->meshes().at(data.primitive.type)),
+m_materialID(MaterialRegistry::global().intern(data.primitive.material)), m_uvRepeat(1.f), m_type(data.primitive.type) {
+    const SceneMaterial& material = data.primitive.material;
+    if (material.textureMap.isUsed) {
+        m_uvRepeat = glm::vec2(material.textureMap.repeatU, material.textureMap.repeatV);
+        if (material.blend < 0 || material.blend > 1) {
             std::cerr << "Invalid blend value for texture map. Must be between 0 and 1." << std::endl;
             m_texture = nullptr;
         }
-        // check if the filename exists in the cache
-        auto maybeTexture = textureCache.find(m_material.textureMap.filename);
-        if (maybeTexture != textureCache.end()) {
-            m_texture = maybeTexture->second;
-            return;
-        } else {
-            // std::cout << "Texture cache miss! Loading texture" << m_material.textureMap.filename << "from file" << std::endl;
-            std::shared_ptr<Image> image = std::shared_ptr<Image>(loadImageFromFile(m_material.textureMap.filename));
-            if (image) {
-                m_texture = std::move(image);
-                // add to cache
-                textureCache[m_material.textureMap.filename] = m_texture;
-                return;
-            }
-        }
+        // nullptr if the image can't be loaded
+        m_texture = scene->textures().acquire(material.textureMap.filename);
+        return;
     }
     m_texture = nullptr;
 }
 
+RealtimeObject::~RealtimeObject() {
+    m_entities->destroy(m_entity);
+}
+
 void RealtimeObject::translate(const glm::vec3& translation) {
-    // LOL GLM TRANSLATE RIGHT MULTIPLIES
-    glm::mat4 transMatrix = glm::translate(glm::mat4(1.f), translation);
-    m_ctm = transMatrix * m_ctm;
-    m_inverseOfTranspose3x3CTM = glm::inverse(glm::transpose(glm::mat3(m_ctm)));
+    m_entities->translate(m_entity, translation);
 }
 
 // default physics tick does nothing
 void RealtimeObject::tick(double elapsedSeconds) {}
 
+bool RealtimeObject::hasTick() const {
+    return false;
+}
+
+void RealtimeObject::sleep() {
+    m_entities->flags(m_entity) |= ENTITY_ASLEEP;
+}
+
+void RealtimeObject::wake() {
+    uint8_t& flags = m_entities->flags(m_entity);
+    flags &= ~ENTITY_ASLEEP;
+    // objects that were put to sleep and woken within one tick are still in the list
+    if (hasTick() && !(flags & ENTITY_IN_TICK_LIST)) {
+        flags |= ENTITY_IN_TICK_LIST;
+        scene()->registerTickObject(this);
+    }
+}
+
+bool RealtimeObject::isAsleep() const {
+    return m_entities->flags(m_entity) & ENTITY_ASLEEP;
+}
+
+void RealtimeObject::leaveTickList() {
+    m_entities->flags(m_entity) &= ~ENTITY_IN_TICK_LIST;
+}
+
 glm::vec3 RealtimeObject::pos() const {
     // get position from last column of CTM
     // TODO this always works right?
-    return {m_ctm[3]};
+    return {CTM()[3]};
 }
 
 const std::shared_ptr<PrimitiveMesh>& RealtimeObject::mesh() const {
     return m_mesh;
 }
 
+const PrimitiveMesh& RealtimeObject::renderMesh() const {
+    return m_mesh->lod(lodLevel());
+}
+
+int RealtimeObject::lodLevel() const {
+    return m_entities->lodLevel(m_entity);
+}
+
+void RealtimeObject::setLODLevel(int level) {
+    m_entities->lodLevel(m_entity) = (uint8_t) level;
+}
+
 const glm::mat4& RealtimeObject::CTM() const {
-    return m_ctm;
+    return m_entities->ctm(m_entity);
 }
 
 const glm::mat3& RealtimeObject::inverseTransposeCTM() const {
-    return m_inverseOfTranspose3x3CTM;
+    return m_entities->normalMatrix(m_entity);
 }
 
 const SceneMaterial& RealtimeObject::material() const {
-    return m_material;
+    return MaterialRegistry::global().get(m_materialID);
+}
+
+MaterialID RealtimeObject::materialID() const {
+    return m_materialID;
+}
+
+const glm::vec2& RealtimeObject::uvRepeat() const {
+    return m_uvRepeat;
 }
 
 PrimitiveType RealtimeObject::type() const {
     return m_type;
 }
 
+const AABB& RealtimeObject::boundingBox() const {
+    uint8_t& flags = m_entities->flags(m_entity);
+    if (!(flags & ENTITY_BOUNDS_VALID)) {
+        m_entities->bounds(m_entity) = m_mesh->computeAABB(CTM());
+        flags |= ENTITY_BOUNDS_VALID;
+    }
+    return m_entities->bounds(m_entity);
+}
+
 bool RealtimeObject::shouldRender() const {
-    return m_shouldRender;
+    return m_entities->flags(m_entity) & ENTITY_RENDER;
 }
 
 void RealtimeObject::setShouldRender(bool shouldRender) {
-    m_shouldRender = shouldRender;
+    uint8_t& flags = m_entities->flags(m_entity);
+    flags = shouldRender ? (flags | ENTITY_RENDER) : (flags & ~ENTITY_RENDER);
 }
 
 std::shared_ptr<RealtimeScene> RealtimeObject::scene() const {
@@ -82,57 +126,29 @@ std::shared_ptr<RealtimeScene> RealtimeObject::scene() const {
 }
 
 void RealtimeObject::queueFree() {
-    m_queuedFree = true;
+    m_entities->flags(m_entity) |= ENTITY_QUEUED_FREE;
 }
 
 bool RealtimeObject::isQueuedFree() const {
-    return m_queuedFree;
-}
-
-void RealtimeObject::setTexture(GLuint textureID) {
-    m_glTexID = textureID;
-    m_glTexAllocated = true;  // Mark the texture as allocated
+    return m_entities->flags(m_entity) & ENTITY_QUEUED_FREE;
 }
 
-
-bool RealtimeObject::usesTexture() const {
-    return m_material.textureMap.isUsed && m_texture != nullptr;
+EntityStore& RealtimeObject::entities() const {
+    return *m_entities;
 }
 
-void RealtimeObject::setMaterial(SceneMaterial& material) {
-    m_material = material;
+EntityID RealtimeObject::entity() const {
+    return m_entity;
 }
 
-bool RealtimeObject::glTexAllocated() const {
-    return m_glTexAllocated;
-}
-
-void RealtimeObject::allocateGLTex() {
-    if (!usesTexture()) {
-        std::cerr << "Cannot allocate texture for object with no texture" << std::endl;
-        return;
-    }
-
-    glGenTextures(1, &m_glTexID);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_glTexID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_texture->width, m_texture->height,
-                 0, GL_RGBA, GL_UNSIGNED_BYTE, m_texture->data.data());
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    m_glTexAllocated = true;
+bool RealtimeObject::usesTexture() const {
+    return material().textureMap.isUsed && m_texture != nullptr;
 }
 
-void RealtimeObject::finish() {
-    if (m_glTexAllocated) {
-        glDeleteTextures(1, &m_glTexID);
-    }
+GLTexture* RealtimeObject::texture() const {
+    return m_texture.get();
 }
 
-GLuint RealtimeObject::glTexID() const {
-    return m_glTexID;
+void RealtimeObject::setMaterial(MaterialID material) {
+    m_materialID = material;
 }
@@ -7,6 +7,9 @@
 #include "utils/sceneparser.h"
 #include "meshes/primitivemesh.h"
 #include "aabb.h"
+#include "entitystore.h"
+#include "materialregistry.h"
+#include "texturemanager.h"
 #include "utils/imagereader.h"
 
 /// only used as a convenience for the factory function in RealtimeScene
@@ -23,12 +26,30 @@ class RealtimeScene;
 
 /// Represents a single object in the scene, with a transformation matrix, material, type, and pointer to the mesh for that type
 /// Base RealtimeObject does not have collision.
+/// The transform, bounds and flags live in the scene's EntityStore rather than in the object itself
 class RealtimeObject {
 public:
     RealtimeObject(const RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene);
+    /// Destroys the object's entity
+    virtual ~RealtimeObject();
+    // each object owns its entity, so copying would destroy it twice
+    RealtimeObject(const RealtimeObject&) = delete;
+    RealtimeObject& operator=(const RealtimeObject&) = delete;
 
-    /// called every physics tick
+    /// called every physics tick, if hasTick() and the object isn't asleep
     virtual void tick(double elapsedSeconds);
+    /// Whether tick() does anything; only objects that return true are put in the scene's tick list, so the rest
+    /// (buildings, floors, objects moved by the EntityStore's systems) cost nothing per tick. Subclasses that
+    /// override tick() must override this too
+    virtual bool hasTick() const;
+    /// Stops ticking the object until wake() is called
+    void sleep();
+    /// Puts the object in the scene's tick list if it has a tick and isn't there already; the scene calls this when
+    /// the object is added, so it only needs to be called after sleep()
+    void wake();
+    bool isAsleep() const;
+    /// Called by the scene when it drops the object from its tick list
+    void leaveTickList();
 
     /// Translates the object by the given vector
     virtual void translate(const glm::vec3& translation);
@@ -36,10 +57,23 @@ public:
     // getters
     glm::vec3 pos() const;
     const std::shared_ptr<PrimitiveMesh>& mesh() const;
+    /// The level of mesh()'s LOD chain to draw this object with
+    const PrimitiveMesh& renderMesh() const;
+    int lodLevel() const;
+    void setLODLevel(int level);
     const glm::mat4& CTM() const;
+    /// Normal matrix of the CTM; computed on first use (see EntityStore::normalMatrix)
     const glm::mat3& inverseTransposeCTM() const;
+    /// The object's (shared) material; its texture repeat is always 1, the object's own repeat is uvRepeat()
     const SceneMaterial& material() const;
+    MaterialID materialID() const;
+    /// Texture repeat in u and v
+    const glm::vec2& uvRepeat() const;
     PrimitiveType type() const;
+    /// World-space bounding box used for culling. Computed from the mesh on first use and moved along with the object;
+    /// for CollisionObjects this is their collision AABB.
+    /// The reference is invalidated when another object is created
+    const AABB& boundingBox() const;
 
     void setShouldRender(bool shouldRender);
     bool shouldRender() const;
@@ -55,32 +89,28 @@ public:
      * @return true if this object uses a texture, false otherwise
      */
     bool usesTexture() const;
-    void setMaterial(SceneMaterial& material);
+    /// Returns the texture of this object, or nullptr if it has none.
+    /// Objects with the same texture file share the same GLTexture (see TextureManager)
+    GLTexture* texture() const;
+    /// Switches to another material from the MaterialRegistry; the texture and uvRepeat stay the same
+    void setMaterial(MaterialID material);
 
-    bool glTexAllocated() const;
-
-    void allocateGLTex();
-
-    void setTexture(GLuint textureID);
-
-    GLuint glTexID() const;
-
-
-    void finish();
+protected:
+    /// The store holding this object's entity (see entity())
+    EntityStore& entities() const;
+    EntityID entity() const;
 
 private:
     std::weak_ptr<RealtimeScene> m_scene;
-    bool m_shouldRender;
-    bool m_queuedFree;
+    /// Shared with the scene, so objects that outlive it can still destroy their entity
+    std::shared_ptr<EntityStore> m_entities;
+    EntityID m_entity;
     std::shared_ptr<PrimitiveMesh> m_mesh;
-    glm::mat4 m_ctm;
-    glm::mat3 m_inverseOfTranspose3x3CTM;
-    SceneMaterial m_material;
+    MaterialID m_materialID;
+    glm::vec2 m_uvRepeat;
     PrimitiveType m_type;
     /// nullptr if this object does not use a texture
-    std::shared_ptr<Image> m_texture;
-    GLuint m_glTexID;
-    bool m_glTexAllocated = false;
+    std::shared_ptr<GLTexture> m_texture;
 };
 
 
@@ -1,14 +1,11 @@
 #pragma once
 #include "realtimeobject.h"
-#include "camera.h"
 
+/// Stays centered on the camera; moved by EntityStore::followCamera rather than its own tick
 class SkyboxObject : public RealtimeObject {
 public:
-    SkyboxObject(const RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene, std::shared_ptr<Camera> camera);
-
-    void tick(double elapsedSeconds) override;
+    SkyboxObject(const RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene);
 private:
-    std::shared_ptr<Camera> m_camera;
     // java-like super
     typedef RealtimeObject super;
 };
\ No newline at end of file
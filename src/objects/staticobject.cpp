@@ -5,6 +5,10 @@ StaticObject::StaticObject(const RenderShapeData& data,
                            const std::shared_ptr<RealtimeScene>& scene) :
                            super(data, scene) {}
 
+StaticObject::StaticObject(const RenderShapeData& data,
+                           const std::shared_ptr<RealtimeScene>& scene, const AABB& aabb) :
+                           super(data, scene, aabb) {}
+
 void StaticObject::translate(const glm::vec3& translation) {
     throw std::runtime_error("Can't translate static object");
 }
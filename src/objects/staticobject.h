@@ -4,6 +4,8 @@
 class StaticObject : public CollisionObject {
 public:
     StaticObject(const RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene);
+    /// `aabb` must be the world-space AABB of the mesh with the data's CTM
+    StaticObject(const RenderShapeData& data, const std::shared_ptr<RealtimeScene>& scene, const AABB& aabb);
     /// can't translate a static object, so this throws an error
     void translate(const glm::vec3& translation) override;
     glm::vec3 translateAndCollide(const glm::vec3& translation) override;
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include "particlesystem.h"
+#include "settings.h"
+
+ParticleSystem::ParticleSystem()
+        : m_posX(MAX_PARTICLES), m_posY(MAX_PARTICLES), m_posZ(MAX_PARTICLES),
+          m_velX(MAX_PARTICLES), m_velY(MAX_PARTICLES), m_velZ(MAX_PARTICLES),
+          m_remainingLife(MAX_PARTICLES), m_size(MAX_PARTICLES),
+          m_rng(std::random_device{}()),
+          m_material{SceneColor{0.1f, 0.1f, 0.1f, 1.f}, SceneColor{1.f, 1.f, 1.f, 1.f}} {}
+
+void ParticleSystem::emitBurst(const ParticleBurst& burst) {
+    auto toEmit = (size_t) std::max(burst.count, 0);
+    if (m_count + toEmit > MAX_PARTICLES) {
+        m_dropped += m_count + toEmit - MAX_PARTICLES;
+        toEmit = MAX_PARTICLES - m_count;
+    }
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    for (size_t i = m_count; i < m_count + toEmit; i++) {
+        glm::vec3 direction;
+        do {
+            direction = glm::vec3(dist(m_rng), dist(m_rng), dist(m_rng));
+        } while (glm::dot(direction, direction) < 1e-6f);
+        direction = glm::normalize(direction);
+        // start just outside the center so the burst doesn't begin as a single point
+        glm::vec3 pos = burst.origin + direction * burst.size;
+        glm::vec3 vel = direction * burst.speed;
+        m_posX[i] = pos.x;
+        m_posY[i] = pos.y;
+        m_posZ[i] = pos.z;
+        m_velX[i] = vel.x;
+        m_velY[i] = vel.y;
+        m_velZ[i] = vel.z;
+        m_remainingLife[i] = burst.lifetime;
+        m_size[i] = burst.size;
+    }
+    m_count += toEmit;
+}
+
+void ParticleSystem::tick(float elapsedSeconds) {
+    // integrate; no branches or dependencies between iterations, so this vectorizes
+    float* posX = m_posX.data();
+    float* posY = m_posY.data();
+    float* posZ = m_posZ.data();
+    const float* velX = m_velX.data();
+    const float* velY = m_velY.data();
+    const float* velZ = m_velZ.data();
+    float* remainingLife = m_remainingLife.data();
+    for (size_t i = 0; i < m_count; i++) {
+        posX[i] += velX[i] * elapsedSeconds;
+        posY[i] += velY[i] * elapsedSeconds;
+        posZ[i] += velZ[i] * elapsedSeconds;
+        remainingLife[i] -= elapsedSeconds;
+    }
+
+    // remove dead particles by moving the last live particle into their slot
+    size_t i = 0;
+    while (i < m_count) {
+        if (m_remainingLife[i] <= 0.f) {
+            m_count--;
+            moveParticle(m_count, i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void ParticleSystem::appendInstances(const PrimitiveMesh& sphere, const Camera& camera, InstanceBatcher& batcher) const {
+    // look up each level's instance list once rather than per particle
+    std::vector<InstanceData>* outByLevel[LOD_LEVELS];
+    for (int level = 0; level < LOD_LEVELS; level++) {
+        outByLevel[level] = &batcher.instancesFor(&sphere.lod(settings.levelOfDetail ? level : 0));
+    }
+    glm::vec3 cAmbient = m_material.cAmbient.xyz();
+    glm::vec3 cDiffuse = m_material.cDiffuse.xyz();
+    glm::vec3 cSpecular = m_material.cSpecular.xyz();
+    glm::vec4 materialParams = glm::vec4(m_material.shininess, m_material.blend, 1.f, 1.f);
+    for (size_t i = 0; i < m_count; i++) {
+        float size = m_size[i];
+        glm::mat4 model = glm::mat4(
+                size, 0.f, 0.f, 0.f,
+                0.f, size, 0.f, 0.f,
+                0.f, 0.f, size, 0.f,
+                m_posX[i], m_posY[i], m_posZ[i], 1.f
+        );
+        // the sphere mesh has a radius of 0.5
+        glm::vec3 pos(m_posX[i], m_posY[i], m_posZ[i]);
+        int level = PrimitiveMesh::lodLevelFor(camera.projectedSize(pos, size * 0.5f));
+        // the scale is uniform, so the normal matrix is just a (normalized-away) scale as well
+        outByLevel[level]->push_back(InstanceData{model, glm::mat3(1.f), cAmbient, cDiffuse, cSpecular, materialParams});
+    }
+}
+
+void ParticleSystem::clear() {
+    m_count = 0;
+}
+
+size_t ParticleSystem::size() const {
+    return m_count;
+}
+
+size_t ParticleSystem::droppedCount() const {
+    return m_dropped;
+}
+
+void ParticleSystem::moveParticle(size_t from, size_t to) {
+    m_posX[to] = m_posX[from];
+    m_posY[to] = m_posY[from];
+    m_posZ[to] = m_posZ[from];
+    m_velX[to] = m_velX[from];
+    m_velY[to] = m_velY[from];
+    m_velZ[to] = m_velZ[from];
+    m_remainingLife[to] = m_remainingLife[from];
+    m_size[to] = m_size[from];
+}
@@ -0,0 +1,66 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include "camera.h"
+#include "instancebatcher.h"
+#include "utils/scenedata.h"
+
+// fixed capacity of the particle pool; bursts that don't fit are truncated
+#define MAX_PARTICLES 16384
+
+/// Parameters for a single burst of particles, all flying outwards from `origin` in random directions
+struct ParticleBurst {
+    glm::vec3 origin;
+    int count;
+    /// Speed of every particle in the burst, in units per second
+    float speed;
+    /// Seconds until the particles disappear
+    float lifetime;
+    /// Scale applied to the sphere mesh for each particle
+    float size;
+};
+
+/// Fixed-capacity pool of short-lived, non-colliding particles (e.g. the sparks when a projectile hits something).
+/// Particles aren't RealtimeObjects: they're stored structure-of-arrays so ticking them is one branch-free loop over
+/// contiguous floats (which the compiler can vectorize), and they're drawn as instances of the sphere mesh
+class ParticleSystem {
+public:
+    ParticleSystem();
+
+    /// Adds a burst of particles to the pool; particles that don't fit in the pool are dropped
+    void emitBurst(const ParticleBurst& burst);
+    /// Moves every particle and removes the ones that have outlived their lifetime
+    void tick(float elapsedSeconds);
+    /// Adds one instance per live particle to `batcher`, drawn with the level of `sphere`'s LOD chain that fits its
+    /// projected size. Particles don't live long enough to flicker between levels, so there's no hysteresis
+    void appendInstances(const PrimitiveMesh& sphere, const Camera& camera, InstanceBatcher& batcher) const;
+    /// Removes every particle
+    void clear();
+
+    /// Returns the number of live particles
+    size_t size() const;
+    /// Returns the number of particles dropped because the pool was full, since the system was created
+    size_t droppedCount() const;
+
+private:
+    /// Moves the particle at `from` into slot `to`
+    void moveParticle(size_t from, size_t to);
+
+    // one array per component; only the first m_count entries are live
+    std::vector<float> m_posX, m_posY, m_posZ;
+    std::vector<float> m_velX, m_velY, m_velZ;
+    std::vector<float> m_remainingLife;
+    std::vector<float> m_size;
+    size_t m_count = 0;
+    size_t m_dropped = 0;
+
+    std::mt19937 m_rng;
+    /// Shared by every particle
+    SceneMaterial m_material;
+};
+
+#pragma clang diagnostic pop
@@ -56,6 +56,7 @@ void Realtime::finish() {
 
     glDeleteProgram(m_filterShader);
     glDeleteProgram(m_phongShader);
+    glDeleteProgram(m_instancedShader);
     glDeleteVertexArrays(1, &m_fullscreen_vao);
     glDeleteBuffers(1, &m_fullscreen_vbo);
     glDeleteTextures(1, &m_fbo_texture);
@@ -102,6 +103,7 @@ void Realtime::initializeGL() {
     glfwSwapInterval(1);
 
     m_phongShader = ShaderLoader::createShaderProgram("resources/shaders/default.vert", "resources/shaders/default.frag");
+    m_instancedShader = ShaderLoader::createShaderProgram("resources/shaders/default_instanced.vert", "resources/shaders/default.frag");
     m_filterShader = ShaderLoader::createShaderProgram("resources/shaders/filter.vert", "resources/shaders/filter.frag");
     m_crosshairShader = ShaderLoader::createShaderProgram("resources/shaders/crosshair.vert", "resources/shaders/crosshair.frag");
     // m_crosshairShader = ShaderLoader::createShaderProgram("resources/shaders/skybox.vert", "resources/shaders/skybox.frag");
@@ -114,6 +116,9 @@ void Realtime::initializeGL() {
     glUseProgram(m_phongShader);
     glUniform1i(glGetUniformLocation(m_phongShader, "objTexture"), 0);
     glUseProgram(0);
+    glUseProgram(m_instancedShader);
+    glUniform1i(glGetUniformLocation(m_instancedShader, "objTexture"), 0);
+    glUseProgram(0);
 
     for (auto& [_, mesh] : m_meshes) {
         // my updateBuffers() function makes sure the mesh is allocated before updating
@@ -230,7 +235,7 @@ void Realtime::paintGL() {
     // we don't really know when exactly the scene is initialized, so just check if we've passed the shader to
     // the scene every frame--it's cheap
     if (!m_scene->shaderInitialized()) {
-        m_scene->initShader(m_phongShader);
+        m_scene->initShader(m_phongShader, m_instancedShader);
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
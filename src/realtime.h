@@ -70,6 +70,7 @@ private:
     int m_param1;
     int m_param2;
     GLuint m_phongShader;
+    GLuint m_instancedShader;
     GLuint m_filterShader;
     GLuint m_crosshairShader;
     GLuint m_skyboxShader;
@@ -1,6 +1,9 @@
 #include <optional>
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
 #include "realtimescene.h"
 #include "objects/realtimeobject.h"
 #include "objects/staticobject.h"
@@ -12,28 +15,24 @@
 #include <utility> // For std::pair
 #include <functional> // For std::hash
 #include "utils/helpers.h"
+#include "utils/imagecache.h"
 #include "material_constants/enemy_materials.h"
+#include "material_constants/city_materials.h"
 #include "objects/skyboxobject.h"
+#include "settings.h"
 
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "ConstantParameter"
-#define MAX_LIGHTS 16
 
-const unsigned int SHADER_LIGHT_POINT       = 0x1u;
-const unsigned int SHADER_LIGHT_DIRECTIONAL = 0x2u;
-const unsigned int SHADER_LIGHT_SPOT        = 0x4u;
 
-
-void printActiveGrids(const std::unordered_set<std::pair<int, int>, pair_hash>& activeGrids) {
+void printActiveGrids(const ChunkRegistry& chunks) {
     std::cout << "Active Grids:" << std::endl;
-    for (const auto& grid : activeGrids) {
+    chunks.forEachActive([](const ChunkRegistry::GridCoord& grid) {
         std::cout << "(" << grid.first << ", " << grid.second << ")" << std::endl;
-    }
+    });
 }
 
-std::unordered_set<std::pair<int, int>, pair_hash> RealtimeScene::m_activeGrids;
-
 
 
 // GLuint loadCubemap(std::vector<std::string> faces) {
@@ -102,9 +101,11 @@ std::shared_ptr<RealtimeScene> RealtimeScene::init(int width, int height, const
     // to this scene to the objects
 
 
+    preloadTextures(renderData);
+
     auto newScene = std::shared_ptr<RealtimeScene>(new RealtimeScene(width, height, nearPlane, farPlane, renderData.globalData, cameraData, std::move(meshes)));
     newScene->m_taken_damage = taken_damage;
-    newScene->m_enemy_spawn_start = std::chrono::steady_clock::now() + std::chrono::milliseconds(GRACE_PERIOD_MS);
+    newScene->m_enemy_spawn_start = GRACE_PERIOD_MS / 1000.0;
     // All initialization must be done here since a shared_ptr to this scene is required.
     newScene->m_lights->reserve(MAX_LIGHTS);
 
@@ -129,26 +130,17 @@ std::shared_ptr<RealtimeScene> RealtimeScene::init(int width, int height, const
     RenderShapeData playerShapeData = RenderShapeData{playerPrimitive, playerCTM};
 
     newScene->m_playerObject = std::make_shared<PlayerObject>(playerShapeData, newScene, newScene->m_camera, newScene->m_lights);
-    auto playerCollisionObject = std::weak_ptr<CollisionObject>(std::static_pointer_cast<CollisionObject>(newScene->m_playerObject));
     auto playerRealtimeObject = std::static_pointer_cast<RealtimeObject>(newScene->m_playerObject);
     newScene->m_objects.push_back(playerRealtimeObject);
-    newScene->m_collisionObjects.push_back(playerCollisionObject);
+    newScene->m_looseObjects.push_back(playerRealtimeObject.get());
+    newScene->registerCollisionObject(newScene->m_playerObject);
+    newScene->m_playerObject->wake();
 
 
   
     // Generate and add the procedural city to the scene
-    int cityRows = 3;   // Number of rows for the city grid
-    int cityCols = 3;   // Number of columns for the city grid
-    float citySpacing = 5.0f; // Spacing between buildings
     std::cout<<"init"<<std::endl;
-    if (RealtimeScene::m_activeGrids.find({0,0}) == m_activeGrids.end())
-    {
-
-    newScene->generateProceduralCity(0,0,cityRows, cityCols, citySpacing);
-
-    }
-
-    RealtimeScene::m_activeGrids.insert({0, 0});
+    newScene->generateProceduralCity(0, 0);
 
     for (const auto& light : renderData.lights) {
         // normalizing is important (and faster to do here than on the gpu for every fragment)
@@ -159,7 +151,7 @@ std::shared_ptr<RealtimeScene> RealtimeScene::init(int width, int height, const
     ScenePrimitive skyboxPrimitive{PrimitiveType::PRIMITIVE_SKYBOX,
         SceneMaterial{SceneColor{0.f, 0.1f, 0.1f, 1.f}, SceneColor{1.f, 1.f, 1.f, 1.f}}};
     skyboxPrimitive.material.textureMap.isUsed = true;
-    skyboxPrimitive.material.textureMap.filename = "scenefiles/moretextures/stars.png";
+    skyboxPrimitive.material.textureMap.filename = SKYBOX_TEXTURE;
 
     skyboxPrimitive.material.blend = 0.5f;  // Adjust blend factor as needed
     skyboxPrimitive.material.textureMap.repeatU = 1.0f;  // Set U repeat value
@@ -167,30 +159,127 @@ std::shared_ptr<RealtimeScene> RealtimeScene::init(int width, int height, const
 
     glm::mat4 skyboxCTM = glm::scale(glm::mat4(1.0f), glm::vec3(100.0f));  // Scale skybox to surround the scene
     RenderShapeData skyboxShapeData = RenderShapeData{skyboxPrimitive, skyboxCTM};
-    auto skyboxObject = std::make_shared<SkyboxObject>(skyboxShapeData, newScene, newScene->m_camera);
+    auto skyboxObject = std::make_shared<SkyboxObject>(skyboxShapeData, newScene);
     auto skyboxObjectRealtime = std::static_pointer_cast<RealtimeObject>(skyboxObject);
     newScene->m_objects.push_back(skyboxObjectRealtime);
+    newScene->m_looseObjects.push_back(skyboxObjectRealtime.get());
     //Add texture for skybox
     return newScene;
 }
 
+void RealtimeScene::preloadTextures(const RenderData& renderData) {
+    std::vector<std::string> paths;
+    for (const RenderShapeData& shape : renderData.shapes) {
+        if (shape.primitive.material.textureMap.isUsed) {
+            paths.push_back(shape.primitive.material.textureMap.filename);
+        }
+    }
+    // the registry starts out with the enemy and city materials
+    const MaterialRegistry& materials = MaterialRegistry::global();
+    for (MaterialID id = 0; id < materials.size(); id++) {
+        if (materials.get(id).textureMap.isUsed) {
+            paths.push_back(materials.get(id).textureMap.filename);
+        }
+    }
+    paths.emplace_back(SKYBOX_TEXTURE);
+    paths.emplace_back(PROJECTILE_TEXTURE);
+    ImageCache::global().preload(paths, (int) std::max(std::thread::hardware_concurrency(), 1u));
+}
+
 RealtimeScene::RealtimeScene(int width, int height, float nearPlane, float farPlane, SceneGlobalData globalData, SceneCameraData cameraData,
                              std::map<PrimitiveType, std::shared_ptr<PrimitiveMesh>> meshes) :
     m_width(width), m_height(height), m_globalData(globalData),
     m_camera(std::make_shared<Camera>(width, height, cameraData, nearPlane, farPlane)),
     m_nearPlane(nearPlane), m_farPlane(farPlane),
-    m_meshes(std::move(meshes)), m_lights(std::make_shared<std::vector<SceneLightData>>(0)) {}
+    m_meshes(std::move(meshes)), m_lights(std::make_shared<std::vector<SceneLightData>>(0)),
+    m_entities(std::make_shared<EntityStore>()),
+    m_collisionGrid(CITY_GRID_SPACING * CITY_GRID_ROWS),
+    m_chunkGenerator(std::make_unique<CityChunkGenerator>(m_meshes.at(PrimitiveType::PRIMITIVE_CUBE),
+                                                          CITY_GRID_ROWS, CITY_GRID_COLS, CITY_GRID_SPACING,
+                                                          settings.cityGenerationThreads)) {}
 
 void RealtimeScene::tick(double elapsedSeconds) {
-    //static double accumulatedTime = 0.0;
-    //super::tick(elapsedSeconds);
-    size_t currentSize = m_objects.size();
-    for (int i = 0; i < currentSize; i++) {
-         m_objects[i]->tick(elapsedSeconds);
-        // size of the vector may change during the tick, so we need to check if the object is still valid
-        currentSize = m_objects.size();
+    using clock = std::chrono::steady_clock;
+    auto secondsSince = [](clock::time_point start) {
+        return std::chrono::duration<double>(clock::now() - start).count();
+    };
+    m_tickStats = TickStats{};
+    m_simTime += elapsedSeconds;
+
+    // input isn't its own phase: key and mouse events reach the player as they arrive, and its tick reads them
+    auto phaseStart = clock::now();
+    tickObjects(elapsedSeconds);
+    m_tickStats.objectTick = secondsSince(phaseStart);
+
+    phaseStart = clock::now();
+    m_particles.tick((float) elapsedSeconds);
+    m_tickStats.particles = secondsSince(phaseStart);
+
+    phaseStart = clock::now();
+    m_commands.commit(*this);
+    //logic for determining when to spawn
+    if (m_simTime - m_time_last_spawn > TIME_BETWEEN_SPAWNS_MS / 1000.0)
+    {
+        m_time_last_spawn = m_simTime;
+        spawnEnemiesInGrids();
+    }
+    //logic for difficulty scaling over time
+    if (m_simTime > m_enemy_spawn_start && m_simTime - m_time_last_scaling > TIME_TO_INCREMENT_SPAWN_S)
+    {
+        current_difficulty_scaling += 1;
+        m_time_last_scaling = m_simTime;
+        if (current_difficulty_scaling * INCREMENT + PROBABILITY_OF_SPAWN < 1) {
+            std::cout << "Things are heating up!" << std::endl;
+        }
+        else
+        {
+            std::cout << "Max difficulty reached. Let's see how long you survive..." << std::endl;
+        }
+    }
+    m_tickStats.spawn = secondsSince(phaseStart);
+
+    phaseStart = clock::now();
+    compactObjects();
+    m_tickStats.compaction = secondsSince(phaseStart);
+
+    // Update the city dynamically based on the player's position
+    phaseStart = clock::now();
+    updateDynamicCity(m_camera->pos(), 2);
+    m_tickStats.dynamicCity = secondsSince(phaseStart);
+}
+
+void RealtimeScene::tickObjects(double elapsedSeconds) {
+    // batched passes over the entity store first, for the objects whose behaviour doesn't need their own tick
+    m_entities->seekTarget(m_camera->pos(), ENEMY_SPEED, ENEMY_DESPAWN_DISTANCE);
+    m_entities->integrateLinearMotion((float) elapsedSeconds);
+
+    // objects spawn through m_commands, so the list doesn't change during the pass (objects woken during it are
+    // appended, and first ticked next step)
+    size_t tickCount = m_tickObjects.size();
+    for (size_t i = 0; i < tickCount; i++) {
+        RealtimeObject* object = m_tickObjects[i];
+        if (object->isAsleep()) {
+            continue;
+        }
+        object->tick(elapsedSeconds);
+        m_tickStats.objectsTicked++;
     }
+    std::erase_if(m_tickObjects, [](RealtimeObject* object) {
+        if (!object->isAsleep()) {
+            return false;
+        }
+        object->leaveTickList();
+        return true;
+    });
+
+    // after the player has moved the camera
+    m_entities->followCamera(m_camera->pos());
+}
 
+void RealtimeScene::compactObjects() {
+    // before m_objects, which may hold the last reference to these objects
+    std::erase_if(m_tickObjects, [](RealtimeObject* object) { return object->isQueuedFree(); });
+    std::erase_if(m_looseObjects, [](RealtimeObject* object) { return object->isQueuedFree(); });
     // https://stackoverflow.com/a/7958447
     m_objects.erase(
         std::remove_if(m_objects.begin(), m_objects.end(),
@@ -201,154 +290,202 @@ void RealtimeScene::tick(double elapsedSeconds) {
         std::remove_if(m_collisionObjects.begin(), m_collisionObjects.end(),
                        [](const std::weak_ptr<CollisionObject>& o) { return o.expired(); }),
         m_collisionObjects.end());
-    //size_t currentSize = m_objects.size();
-    for (int i = 0; i < currentSize; i++) {
-        m_objects[i]->tick(elapsedSeconds);
-        currentSize = m_objects.size();
-    }
+}
 
-    m_objects.erase(
-        std::remove_if(m_objects.begin(), m_objects.end(),
-                       [](const std::shared_ptr<RealtimeObject>& o) { return o->isQueuedFree(); }),
-        m_objects.end());
-    m_collisionObjects.erase(
-        std::remove_if(m_collisionObjects.begin(), m_collisionObjects.end(),
-                       [](const std::weak_ptr<CollisionObject>& o) { return o.expired(); }),
-        m_collisionObjects.end());
+const RealtimeScene::TickStats& RealtimeScene::lastTickStats() const {
+    return m_tickStats;
+}
 
-    // Update the city dynamically based on the player's position
+double RealtimeScene::simTime() const {
+    return m_simTime;
+}
 
+void RealtimeScene::seedRandom(unsigned int seed) {
+    m_rng.seed(seed);
+}
 
-    updateDynamicCity(m_camera->pos(), 2);
+void RealtimeScene::paintObjects() {
+    if (!shaderInitialized()) {
+        std::cerr << "Failed to paint objects: shader not initialized" << std::endl;
+        return;
+    }
 
-    //logic for determining when to spawn
-    if (std::chrono::steady_clock::now() - m_time_last_spawn > std::chrono::milliseconds(TIME_BETWEEN_SPAWNS_MS))
-    {
-        m_time_last_spawn = std::chrono::steady_clock::now();
-        spawnEnemiesInGrids();
+    // textures of objects freed during the last ticks can only be deleted now that the GL context is current
+    m_textures.collectGarbage();
+    collectVisibleObjects();
+    selectLODs();
+    m_lightBuffer.update(*m_lights);
+    if (settings.instancedRendering) {
+        paintObjectsInstanced();
+    } else {
+        paintObjectsIndividually();
+        paintParticles();
     }
-    //logic for difficulty scaling over time
-    if (std::chrono::steady_clock::now() > m_enemy_spawn_start  && std::chrono::steady_clock::now() - m_time_last_scaling > std::chrono::seconds(TIME_TO_INCREMENT_SPAWN_S))
-    {
-        current_difficulty_scaling += 1;
-        m_time_last_scaling = std::chrono::steady_clock::now();
-        if (current_difficulty_scaling * INCREMENT + PROBABILITY_OF_SPAWN < 1) {
-            std::cout << "Things are heating up!" << std::endl;
+    glUseProgram(0);
+}
+
+const RealtimeScene::CullingStats& RealtimeScene::cullingStats() const {
+    return m_cullingStats;
+}
+
+void RealtimeScene::collectVisibleObjects() {
+    m_visibleObjects.clear();
+    m_cullingStats = CullingStats{};
+
+    if (!settings.frustumCulling) {
+        // walk the entity store rather than m_objects, so the flags are read from a contiguous array
+        EntityStore& entities = *m_entities;
+        for (size_t i = 0; i < entities.size(); i++) {
+            if (entities.flagsAt(i) & ENTITY_RENDER) {
+                m_visibleObjects.push_back(entities.ownerAt(i));
+            }
         }
-        else
-        {
-            std::cout << "Max difficulty reached. Let's see how long you survive..." << std::endl;
+        m_cullingStats.submitted = (int) m_visibleObjects.size();
+        return;
+    }
+
+    const Frustum& frustum = m_camera->frustum();
+    auto testObject = [&](RealtimeObject& object) {
+        if (!object.shouldRender()) {
+            return;
+        }
+        // computes the bounds from the mesh the first time
+        if (!frustum.intersects(object.boundingBox())) {
+            m_cullingStats.culled++;
+            return;
+        }
+        m_visibleObjects.push_back(&object);
+    };
+    // a cell's bounds contain all of its objects, so a rejected cell rejects all of them
+    m_chunks.forEachActive([&](const ChunkRegistry::GridCoord& cell) {
+        if (m_chunks.objectCount(cell) == 0) {
+            return;
         }
+        m_cullingStats.cellsTested++;
+        if (!frustum.intersects(m_chunks.bounds(cell))) {
+            m_cullingStats.cellsCulled++;
+            m_cullingStats.culled += (int) m_chunks.objectCount(cell);
+            return;
+        }
+        m_chunks.forEachObject(cell, testObject);
+    });
+    for (RealtimeObject* object : m_looseObjects) {
+        testObject(*object);
     }
+    m_cullingStats.submitted = (int) m_visibleObjects.size();
 }
 
-void RealtimeScene::paintObjects() {
-    if (!shaderInitialized()) {
-        std::cerr << "Failed to paint objects: shader not initialized" << std::endl;
+void RealtimeScene::selectLODs() {
+    for (RealtimeObject* object : m_visibleObjects) {
+        if (!settings.levelOfDetail) {
+            object->setLODLevel(0);
+            continue;
+        }
+        const AABB& box = object->boundingBox();
+        float radius = glm::length(box.max - box.min) * 0.5f;
+        float screenSize = m_camera->projectedSize((box.min + box.max) * 0.5f, radius);
+        object->setLODLevel(PrimitiveMesh::selectLOD(screenSize, object->lodLevel()));
+    }
+}
+
+void RealtimeScene::useShaderWithSceneUniforms(GLuint shader, const UniformLocations& uniforms) {
+    glUseProgram(shader);
+    m_activeUniforms = &uniforms;
+    passUniformMat4(Uniform::VIEW, m_camera->viewMatrix());
+    passUniformMat4(Uniform::PROJ, m_camera->projectionMatrix());
+    passUniformVec3(Uniform::CAMERA_POS_WS, m_camera->pos().xyz());
+    passUniformFloat(Uniform::KA, m_globalData.ka);
+    passUniformFloat(Uniform::KD, m_globalData.kd);
+    passUniformFloat(Uniform::KS, m_globalData.ks);
+}
+
+void RealtimeScene::paintObjectsInstanced() {
+    useShaderWithSceneUniforms(*m_instancedShader, m_instancedUniforms);
+    m_instanceBatcher.begin();
+    for (RealtimeObject* object : m_visibleObjects) {
+        m_instanceBatcher.add(*object);
+    }
+    m_particles.appendInstances(*m_meshes.at(PrimitiveType::PRIMITIVE_SPHERE), *m_camera, m_instanceBatcher);
+    m_instanceBatcher.draw(m_instancedUniforms);
+}
+
+void RealtimeScene::paintParticles() {
+    if (m_particles.size() == 0) {
         return;
     }
+    useShaderWithSceneUniforms(*m_instancedShader, m_instancedUniforms);
+    m_instanceBatcher.begin();
+    m_particles.appendInstances(*m_meshes.at(PrimitiveType::PRIMITIVE_SPHERE), *m_camera, m_instanceBatcher);
+    m_instanceBatcher.draw(m_instancedUniforms);
+}
 
-    glUseProgram(*m_phongShader);
-    passUniformMat4("view", m_camera->viewMatrix());
-    passUniformMat4("proj", m_camera->projectionMatrix());
-    passUniformInt("numLights", (int) m_lights->size());
-    passUniformLightArray("lights", m_lights);
-    passUniformVec3("cameraPosWS", m_camera->pos().xyz());
-    passUniformFloat("ka", m_globalData.ka);
-    passUniformFloat("kd", m_globalData.kd);
-    passUniformFloat("ks", m_globalData.ks);
+void RealtimeScene::paintObjectsIndividually() {
+    useShaderWithSceneUniforms(*m_phongShader, m_phongUniforms);
     // set texture slot
     glActiveTexture(GL_TEXTURE0);
-    for (const auto& object : m_objects) {
-        if (!object->shouldRender()) {
-            continue;
-        }
+    // draw objects with the same material one after another, so their material uniforms only have to be passed once
+    std::sort(m_visibleObjects.begin(), m_visibleObjects.end(), [](const RealtimeObject* a, const RealtimeObject* b) {
+        return a->materialID() < b->materialID();
+    });
+    std::optional<MaterialID> passedMaterial;
+    for (RealtimeObject* object : m_visibleObjects) {
         const SceneMaterial& material = object->material();
+        if (object->materialID() != passedMaterial) {
+            passUniformVec3(Uniform::MATERIAL_AMBIENT, material.cAmbient.xyz());
+            passUniformVec3(Uniform::MATERIAL_DIFFUSE, material.cDiffuse.xyz());
+            passUniformVec3(Uniform::MATERIAL_SPECULAR, material.cSpecular.xyz());
+            passUniformFloat(Uniform::MATERIAL_SHININESS, material.shininess);
+            passUniformFloat(Uniform::MATERIAL_BLEND, material.blend);
+            passedMaterial = object->materialID();
+        }
         if (object->usesTexture()) {
-            if (!object->glTexAllocated()) {
-                object->allocateGLTex();
-            }
-            glBindTexture(GL_TEXTURE_2D, object->glTexID());
-            passUniformInt("usesTexture", 1);
-            // TODO is it okay to sometimes not pass these uniforms?
-            passUniformFloat("blend", material.blend);
-            passUniformFloat("repeatU", material.textureMap.repeatU);
-            passUniformFloat("repeatV", material.textureMap.repeatV);
+            glBindTexture(GL_TEXTURE_2D, object->texture()->id());
+            passUniformInt(Uniform::USES_TEXTURE, 1);
+            passUniformFloat(Uniform::MATERIAL_REPEAT_U, object->uvRepeat().x);
+            passUniformFloat(Uniform::MATERIAL_REPEAT_V, object->uvRepeat().y);
         } else {
-            passUniformInt("usesTexture", 0);
+            passUniformInt(Uniform::USES_TEXTURE, 0);
         }
-        passUniformMat4("model", object->CTM());
-        passUniformMat3("inverseTransposeModel", object->inverseTransposeCTM());
-        passUniformVec3("cAmbient", material.cAmbient.xyz());
-        passUniformVec3("cDiffuse", material.cDiffuse.xyz());
-        passUniformVec3("cSpecular", material.cSpecular.xyz());
-        passUniformFloat("shininess", material.shininess);
-        glBindVertexArray(object->mesh()->vao());
+        passUniformMat4(Uniform::MODEL, object->CTM());
+        passUniformMat3(Uniform::INVERSE_TRANSPOSE_MODEL, object->inverseTransposeCTM());
+        const PrimitiveMesh& mesh = object->renderMesh();
+        glBindVertexArray(mesh.vao());
         if (object->type() == PrimitiveType::PRIMITIVE_SKYBOX)
         {
-            passUniformInt("isSkybox", 1);
+            passUniformInt(Uniform::IS_SKYBOX, 1);
         } else
         {
-            passUniformInt("isSkybox", 0);
+            passUniformInt(Uniform::IS_SKYBOX, 0);
         }
-        glDrawArrays(GL_TRIANGLES, 0, (GLsizei) (object->mesh()->vertexData().size() / 3));
+        mesh.draw();
         glBindVertexArray(0);
         if (object->usesTexture()) {
             glBindTexture(GL_TEXTURE_2D, 0);
         }
     }
-    glUseProgram(0);
-}
-
-
-
-
-void RealtimeScene::passUniformMat4(const char* name, const glm::mat4& mat) {
-    helpers::passUniformMat4(m_phongShader.value(), name, mat);
 }
 
-void RealtimeScene::passUniformMat3(const char* name, const glm::mat3& mat) {
-    helpers::passUniformMat3(m_phongShader.value(), name, mat);
-}
 
-void RealtimeScene::passUniformFloat(const char* name, float value) {
-    helpers::passUniformFloat(m_phongShader.value(), name, value);
-}
 
-void RealtimeScene::passUniformInt(const char* name, int value) {
-    helpers::passUniformInt(m_phongShader.value(), name, value);
-}
 
-void RealtimeScene::passUniformVec3(const char* name, const glm::vec3& vec) {
-    helpers::passUniformVec3(m_phongShader.value(), name, vec);
+void RealtimeScene::passUniformMat4(Uniform uniform, const glm::mat4& mat) {
+    helpers::passUniformMat4((*m_activeUniforms)[uniform], mat);
 }
 
-void RealtimeScene::passUniformVec3Array(const char* name, const std::vector<glm::vec3>& vecs) {
-    helpers::passUniformVec3Array(m_phongShader.value(), name, vecs);
+void RealtimeScene::passUniformMat3(Uniform uniform, const glm::mat3& mat) {
+    helpers::passUniformMat3((*m_activeUniforms)[uniform], mat);
 }
 
-void RealtimeScene::passUniformLightArray(const char* name, std::shared_ptr<std::vector<SceneLightData>> lights) {
-    // hmm this will cause allocations every time TODO maybe optimize
-    std::string lightName = std::string(name);
-    for (int i = 0; i < lights->size(); i++) {
-        passUniformLight((lightName + "[" + std::to_string(i) + "]").c_str(), (*lights)[i]);
-    }
+void RealtimeScene::passUniformFloat(Uniform uniform, float value) {
+    helpers::passUniformFloat((*m_activeUniforms)[uniform], value);
 }
 
-void RealtimeScene::passUniformLight(const char* name, SceneLightData type) {
-    // hmm this will cause allocations every time TODO maybe optimize
-    std::string lightName = std::string(name);
-    glUniform1ui(getUniformLocation((lightName + ".type").c_str()), lightTypeToUniform(type.type));
-    glUniform3fv(getUniformLocation((lightName + ".color").c_str()), 1, &type.color.xyz()[0]);
-    glUniform3fv(getUniformLocation((lightName + ".pos").c_str()), 1, &type.pos.xyz()[0]);
-    glUniform3fv(getUniformLocation((lightName + ".dir").c_str()), 1, &type.dir.xyz()[0]);
-    glUniform3fv(getUniformLocation((lightName + ".function").c_str()), 1, &type.function[0]);
-    glUniform1f(getUniformLocation((lightName + ".penumbra").c_str()), type.penumbra);
-    glUniform1f(getUniformLocation((lightName + ".angle").c_str()), type.angle);
+void RealtimeScene::passUniformInt(Uniform uniform, int value) {
+    helpers::passUniformInt((*m_activeUniforms)[uniform], value);
 }
 
-GLint RealtimeScene::getUniformLocation(const char* name, bool checkValidLoc) const {
-    return helpers::getUniformLocation(m_phongShader.value(), name, checkValidLoc);
+void RealtimeScene::passUniformVec3(Uniform uniform, const glm::vec3& vec) {
+    helpers::passUniformVec3((*m_activeUniforms)[uniform], vec);
 }
 
 void RealtimeScene::setDimensions(int width, int height) {
@@ -366,12 +503,17 @@ void RealtimeScene::updateSettings(float nearPlane, float farPlane) {
     }
 }
 
-void RealtimeScene::initShader(GLuint phongShader) {
+void RealtimeScene::initShader(GLuint phongShader, GLuint instancedShader) {
     m_phongShader = phongShader;
+    m_instancedShader = instancedShader;
+    m_phongUniforms = UniformLocations(phongShader);
+    m_instancedUniforms = UniformLocations(instancedShader);
+    LightBuffer::bindBlock(phongShader);
+    LightBuffer::bindBlock(instancedShader);
 }
 
 bool RealtimeScene::shaderInitialized() const {
-    return m_phongShader.has_value();
+    return m_phongShader.has_value() && m_instancedShader.has_value();
 }
 
 
@@ -383,19 +525,6 @@ int RealtimeScene::height() const {
     return m_height;
 }
 
-GLuint RealtimeScene::lightTypeToUniform(LightType type) {
-    switch (type) {
-    case LightType::LIGHT_POINT:
-        return SHADER_LIGHT_POINT;
-    case LightType::LIGHT_DIRECTIONAL:
-        return SHADER_LIGHT_DIRECTIONAL;
-    case LightType::LIGHT_SPOT:
-        return SHADER_LIGHT_SPOT;
-    default:
-        throw std::runtime_error("Invalid light type");
-    }
-}
-
 void RealtimeScene::keyPressEvent(int key) {
     m_playerObject->keyPressEvent(key);
 }
@@ -431,10 +560,9 @@ std::shared_ptr<RealtimeObject> RealtimeScene::addObject(PrimitiveType type, con
 }
 
 void RealtimeScene::addEnemy(glm::vec3 position) {
-    std::mt19937 gen(std::random_device{}());
-    float scale1 = std::uniform_real_distribution<float>(0.9, 1.1)(gen);
-    float scale2 = std::uniform_real_distribution<float>(0.9, 1.1)(gen);
-    float scale3 = std::uniform_real_distribution<float>(0.9, 1.1)(gen);
+    float scale1 = std::uniform_real_distribution<float>(0.9, 1.1)(m_rng);
+    float scale2 = std::uniform_real_distribution<float>(0.9, 1.1)(m_rng);
+    float scale3 = std::uniform_real_distribution<float>(0.9, 1.1)(m_rng);
 
     ScenePrimitive enemyPrimitive{PrimitiveType::PRIMITIVE_CYLINDER, enemy_materials::getRandomEnemyMaterial()};
     glm::mat4 enemyCTM = glm::translate(glm::scale(glm::mat4(1.0f), glm::vec3(scale1,scale2,scale3)), position);
@@ -447,6 +575,14 @@ void RealtimeScene::addEnemy(glm::vec3 position) {
 }
 
 std::shared_ptr<RealtimeObject> RealtimeScene::addObject(std::unique_ptr<RealtimeObject> object) {
+    std::shared_ptr<RealtimeObject> objectShared = insertObject(std::move(object));
+    if (objectShared) {
+        m_looseObjects.push_back(objectShared.get());
+    }
+    return objectShared;
+}
+
+std::shared_ptr<RealtimeObject> RealtimeScene::insertObject(std::unique_ptr<RealtimeObject> object) {
     std::shared_ptr<RealtimeObject> objectShared = std::move(object);
     if (!objectShared) {
         std::cerr << "Failed to add object to scene: object is null" << std::endl;
@@ -456,160 +592,131 @@ std::shared_ptr<RealtimeObject> RealtimeScene::addObject(std::unique_ptr<Realtim
     // if so, we have to add it to the collision objects list
     std::shared_ptr<CollisionObject> maybeCollisionObject = std::dynamic_pointer_cast<CollisionObject>(objectShared);
     if (maybeCollisionObject) {
-        std::weak_ptr<CollisionObject> collisionObject = std::weak_ptr<CollisionObject>(maybeCollisionObject);
-        m_collisionObjects.push_back(collisionObject);
+        registerCollisionObject(maybeCollisionObject);
     }
     m_objects.push_back(objectShared);
+    // objects without a tick aren't added
+    objectShared->wake();
     return objectShared;
 }
 
+void RealtimeScene::registerTickObject(RealtimeObject* object) {
+    m_tickObjects.push_back(object);
+}
+
 
 const std::map<PrimitiveType, std::shared_ptr<PrimitiveMesh>>& RealtimeScene::meshes() const {
     return m_meshes;
 }
 
+TextureManager& RealtimeScene::textures() {
+    return m_textures;
+}
+
 const std::vector<std::weak_ptr<CollisionObject>>& RealtimeScene::collisionObjects() const {
     return m_collisionObjects;
 }
 
+CollisionGrid& RealtimeScene::collisionGrid() {
+    return m_collisionGrid;
+}
 
+ParticleSystem& RealtimeScene::particles() {
+    return m_particles;
+}
 
+SceneCommandBuffer& RealtimeScene::commands() {
+    return m_commands;
+}
 
-void RealtimeScene::generateProceduralCity(int gridX, int gridZ, int rows, int cols, float spacing) {
-    std::default_random_engine generator;
-    std::uniform_real_distribution<float> heightDist(1.0f, 15.0f);
-    std::uniform_real_distribution<float> widthDist(1.0f, 3.0f);
-    std::uniform_real_distribution<float> depthDist(1.0f, 3.0f);
-
-    float baseX = gridX * cols * spacing;
-    float baseZ = gridZ * rows * spacing;
-
-    // find location to spawn enemy
-    if (std::chrono::steady_clock::now() > m_enemy_spawn_start) {
-        // std::cout << "adding " << gridX << ", " << gridZ << std::endl;
-        m_enemy_spawn_locations[glm::vec2(gridX,gridZ)] = glm::vec3(baseX, 0.0f, baseZ);
-    }
+const std::shared_ptr<EntityStore>& RealtimeScene::entities() const {
+    return m_entities;
+}
 
-    float floorWidth = cols * spacing;
-    float floorDepth = rows * spacing;
-    float floorHeight = 0.1f;
+void RealtimeScene::registerCollisionObject(const std::shared_ptr<CollisionObject>& object) {
+    m_collisionObjects.push_back(std::weak_ptr<CollisionObject>(object));
+    m_collisionGrid.insert(object);
+}
 
-    glm::vec3 floorPosition(
-        baseX + floorWidth / 2.0f - spacing / 2.0f,
-        -floorHeight / 2.0f - 3.f,
-        baseZ + floorDepth / 2.0f - spacing / 2.0f
-        );
 
-    glm::mat4 floorTransform = glm::translate(glm::mat4(1.0f), floorPosition) *
-                               glm::scale(glm::mat4(1.0f), glm::vec3(floorWidth, floorHeight, floorDepth));
 
-    SceneMaterial floorMaterial;
-    floorMaterial.cDiffuse = SceneColor(0.2f, 0.2f, 0.2f, 1.0f);
-    floorMaterial.cAmbient = SceneColor(0.1f, 0.1f, 0.1f, 1.0f);
-    floorMaterial.cSpecular = SceneColor(0.2f, 0.2f, 0.2f, 1.0f);
-    floorMaterial.shininess = 5.0f;
 
-    floorMaterial.textureMap.isUsed = true;
-    floorMaterial.textureMap.filename = "scenefiles/moretextures/doomfloor.jpg";
+void RealtimeScene::generateProceduralCity(int gridX, int gridZ) {
+    CityChunk chunk = m_chunkGenerator->generate(gridX, gridZ);
+    beginCommittingChunk(gridX, gridZ);
+    int budget = (int) chunk.pieces.size();
+    commitChunkPieces(chunk, 0, budget);
+}
 
-    floorMaterial.blend = 0.5f;
-    floorMaterial.textureMap.repeatU = 1.0f;
-    floorMaterial.textureMap.repeatV = 1.0f;
+namespace {
+    SceneMaterial cityMaterial(CityMaterial id, const glm::vec2& uvRepeat) {
+        SceneMaterial material = id == CityMaterial::FLOOR ? city_materials::floorMaterial : city_materials::buildingMaterial;
+        material.textureMap.repeatU = uvRepeat.x;
+        material.textureMap.repeatV = uvRepeat.y;
+        return material;
+    }
+}
 
-    // add floor
-    addObject(PrimitiveType::PRIMITIVE_CUBE, floorTransform, floorMaterial, RealtimeObjectType::STATIC);
+void RealtimeScene::beginCommittingChunk(int gridX, int gridZ) {
+    m_chunks.activate({gridX, gridZ});
+    float baseX = gridX * CITY_GRID_COLS * CITY_GRID_SPACING;
+    float baseZ = gridZ * CITY_GRID_ROWS * CITY_GRID_SPACING;
 
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            int globalX = gridX * rows + i;
-            int globalZ = gridZ * cols + j;
-            std::pair<int, int> gridCoord = {globalX, globalZ};
+    // find location to spawn enemy
+    if (m_simTime > m_enemy_spawn_start) {
+        // std::cout << "adding " << gridX << ", " << gridZ << std::endl;
+        m_enemy_spawn_locations[glm::vec2(gridX,gridZ)] = glm::vec3(baseX, 0.0f, baseZ);
+    }
+}
 
-            if (existingBuildings.find(gridCoord) != existingBuildings.end()) {
+size_t RealtimeScene::commitChunkPieces(const CityChunk& chunk, size_t firstPiece, int& budget) {
+    ChunkRegistry::GridCoord cell = {chunk.gridX, chunk.gridZ};
+    size_t i = firstPiece;
+    for (; i < chunk.pieces.size() && budget > 0; i++) {
+        const CityChunkPiece& piece = chunk.pieces[i];
+        if (piece.material == CityMaterial::BUILDING) {
+            if (m_chunks.hasBuilding(piece.buildingCoord)) {
                 continue;
             }
-
-            float height = heightDist(generator);
-            float width = widthDist(generator);
-            float depth = depthDist(generator);
-
-            glm::vec3 position(
-                baseX + i * spacing,
-                height / 2.0f - 3,
-                baseZ + j * spacing
-                );
-            //std::cout << "Building position: (" << position.x << ", " << position.y << ", " << position.z << ")\n";
-
-            glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) *
-                                  glm::scale(glm::mat4(1.0f), glm::vec3(width, height, depth));
-
-            SceneMaterial material;
-            material.cDiffuse = SceneColor(0.3f, 0.3f, 0.3f, 1.0f);
-            material.cAmbient = SceneColor(0.1f, 0.1f, 0.1f, 1.0f);
-            material.cSpecular = SceneColor(0.5f, 0.5f, 0.5f, 1.0f);
-            material.shininess = 10.0f;
-            material.textureMap.isUsed = true;
-            material.textureMap.filename = "scenefiles/moretextures/city.jpg";
-
-            material.blend = 0.5f;
-            material.textureMap.repeatU = ((width + depth) / 2.f) / 5.f;
-            material.textureMap.repeatV = (height) / 5.f;
-
-            // add building
-            // std::cout << "Adding building at " << position.x << ", " << position.y << ", " << position.z << std::endl;
-            // std::cout << "Total existing buildings: " << existingBuildings.size() << std::endl;
-            // std::cout << "Total active grids: " << m_activeGrids.size() << std::endl;
-            // std::cout << "Total objects: " << m_objects.size() << std::endl;
-            addObject(PrimitiveType::PRIMITIVE_CUBE, transform, material, RealtimeObjectType::STATIC);
-
-            existingBuildings.insert(gridCoord);
+            m_chunks.addBuilding(cell, piece.buildingCoord);
         }
+        RenderShapeData data{ScenePrimitive{PrimitiveType::PRIMITIVE_CUBE, cityMaterial(piece.material, piece.uvRepeat)},
+                             piece.ctm};
+        // culled along with the cell, so it doesn't go in m_looseObjects
+        m_chunks.addObject(cell, insertObject(std::make_unique<StaticObject>(data, shared_from_this(), piece.aabb)));
+        budget--;
     }
+    return i;
 }
+
 void RealtimeScene::spawnEnemiesInGrids()
 {
-    //some junk to get a random float between 0 and 1
-    std::mt19937 gen(std::random_device{}());
     // std::cout << m_enemy_spawn_locations.size() << std::endl;
 
     for (auto& pair : m_enemy_spawn_locations) {
-        if (std::uniform_real_distribution<float>(0.0, 1.0)(gen) < PROBABILITY_OF_SPAWN + (current_difficulty_scaling * INCREMENT))
+        //some junk to get a random float between 0 and 1
+        if (std::uniform_real_distribution<float>(0.0, 1.0)(m_rng) < PROBABILITY_OF_SPAWN + (current_difficulty_scaling * INCREMENT))
         {
             addEnemy(pair.second); //add enemy at 3
         }
     }
 }
 
-void RealtimeScene::removeGridObjects(int gridX, int gridZ, int rows, int cols) {
-    float spacing=5.f;
-    float baseX = gridX * cols * spacing;
-    float baseZ = gridZ * rows * spacing;
-
-    for (auto it = m_objects.begin(); it != m_objects.end();) {
-        glm::vec3 objPos = (*it)->pos();
-        if (objPos.x >= baseX && objPos.x < baseX + cols * spacing &&
-            objPos.z >= baseZ && objPos.z < baseZ + rows * spacing) {
-            (*it)->queueFree();
-            it = m_objects.erase(it);
-        } else {
-            ++it;
-        }
-    }
-
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            existingBuildings.erase({gridX * rows + i, gridZ * cols + j});
-        }
-    }
-}
-
 void RealtimeScene::updateDynamicCity(const glm::vec3& playerPosition, int gridCellUpdateDist) {
-    // std::cout << m_activeGrids.size() << std::endl;
-    // printActiveGrids(m_activeGrids);
-
-    float spacing = 5.f;
-    int rows = 3;
-    int cols = 3;
+    // std::cout << m_chunks.size() << std::endl;
+    // printActiveGrids(m_chunks);
+
+    float spacing = CITY_GRID_SPACING;
+    int rows = CITY_GRID_ROWS;
+    int cols = CITY_GRID_COLS;
+
+    // keep track of which way the player is heading (keeping the last heading while they stand still),
+    // so the chunks in front of them get generated first
+    glm::vec2 movement = glm::vec2(playerPosition.x - m_lastPlayerPosition.x, playerPosition.z - m_lastPlayerPosition.z);
+    if (glm::length(movement) > EPSILON) {
+        m_playerHeading = glm::normalize(movement);
+    }
+    m_lastPlayerPosition = playerPosition;
 
     // determine which grid the player is in
     int playerGridX = static_cast<int>(playerPosition.x / (cols * spacing));
@@ -617,6 +724,17 @@ void RealtimeScene::updateDynamicCity(const glm::vec3& playerPosition, int gridC
 
     // std::cout << "player is in " << playerGridX  << " ," << playerGridZ << std::endl;
 
+    // the player's own cell can't wait for a worker thread (they'd fall through the floor), so finish it right away
+    std::pair<int, int> playerGrid = {playerGridX, playerGridZ};
+    if (m_chunkInProgress.has_value() && m_chunkInProgress->gridX == playerGridX && m_chunkInProgress->gridZ == playerGridZ) {
+        int budget = (int) m_chunkInProgress->pieces.size();
+        commitChunkPieces(*m_chunkInProgress, m_nextChunkPiece, budget);
+        m_chunkInProgress.reset();
+    } else if (!m_chunks.isActive(playerGrid)) {
+        m_awaitedChunks.erase(playerGrid);
+        generateProceduralCity(playerGridX, playerGridZ);
+    }
+
     int startDelta = -gridCellUpdateDist;
     int endDelta = gridCellUpdateDist;
 
@@ -625,46 +743,77 @@ void RealtimeScene::updateDynamicCity(const glm::vec3& playerPosition, int gridC
             int neighborGridX = playerGridX + dx;
             int neighborGridZ = playerGridZ + dz;
 
-            // float gridCenterX = neighborGridX * cols * spacing + cols * spacing / 2.0f;
-            // float gridCenterZ = neighborGridZ * rows * spacing + rows * spacing / 2.0f;
-
-            // float dist = glm::distance(playerPosition, glm::vec3(gridCenterX, 0, gridCenterZ));
-
-            if (m_activeGrids.find({neighborGridX, neighborGridZ}) == m_activeGrids.end()) {
-                generateProceduralCity(neighborGridX, neighborGridZ, rows, cols, spacing);
-                m_activeGrids.insert({neighborGridX, neighborGridZ});
-                // std::cout << "Activated grid: (" << neighborGridX << ", " << neighborGridZ << ", dist: " << dist << ")\n";
+            if (m_chunks.isActive({neighborGridX, neighborGridZ})) {
+                continue;
             }
+            // queue the chunk (or update its priority if it's already queued): closer is sooner, and cells in the
+            // direction the player is heading count as up to twice as close
+            glm::vec2 toCell = glm::vec2(dx, dz) * glm::vec2(cols * spacing, rows * spacing);
+            float distance = glm::length(toCell);
+            float alignment = distance > 0.f ? glm::dot(m_playerHeading, toCell / distance) : 0.f;
+            m_chunkGenerator->request(neighborGridX, neighborGridZ, distance * (1.f - 0.5f * alignment));
+            m_awaitedChunks.insert({neighborGridX, neighborGridZ});
         }
     }
 
     // remove grids that are too far from the player
-    auto it = m_activeGrids.begin();
-    while (it != m_activeGrids.end()) {
-        int gridX = it->first;
-        int gridZ = it->second;
-
+    auto isTooFar = [&](int gridX, int gridZ) {
         int manhanttanGridDistFromPlayer = std::abs(playerGridX - gridX) + std::abs(playerGridZ - gridZ);
-
-        // deactivate the grid if it is too far
-        if (manhanttanGridDistFromPlayer > gridCellUpdateDist * 2) {
-            removeGridObjects(gridX, gridZ, rows, cols);
-            it = m_activeGrids.erase(it);
-
-            //remove the grid's coordinates from the vector of spawn locations
-            // std::cout << "removing " << gridX << ", " << gridZ << std::endl;
-            // m_enemy_spawn_locations.erase(glm::vec2(gridX, gridZ));
-            // std::cout << "Deactivated grid: (" << gridX << ", " << gridZ << ", dist: " << dist << ", updateRadius: " << updateRadius << ")\n";
-        } else {
-            ++it;
+        return manhanttanGridDistFromPlayer > gridCellUpdateDist * 2;
+    };
+    // unloading only queues the grid's own objects for freeing; the next compaction in tick drops them
+    m_chunks.unloadIf([&](const ChunkRegistry::GridCoord& grid) {
+        if (!isTooFar(grid.first, grid.second)) {
+            return false;
+        }
+        if (m_chunkInProgress.has_value() && m_chunkInProgress->gridX == grid.first && m_chunkInProgress->gridZ == grid.second) {
+            m_chunkInProgress.reset();
+        }
+        //remove the grid's coordinates from the vector of spawn locations
+        // std::cout << "removing " << grid.first << ", " << grid.second << std::endl;
+        // m_enemy_spawn_locations.erase(glm::vec2(grid.first, grid.second));
+        return true;
+    });
+    // chunks that haven't arrived yet are simply dropped when they do
+    std::erase_if(m_awaitedChunks, [&](const std::pair<int, int>& grid) { return isTooFar(grid.first, grid.second); });
+
+    commitFinishedChunks();
+}
+
+void RealtimeScene::commitFinishedChunks() {
+    m_chunkGenerator->takeFinished(m_finishedChunks);
+    int budget = CITY_COMMIT_BUDGET;
+    while (budget > 0) {
+        if (!m_chunkInProgress.has_value()) {
+            if (m_finishedChunkIndex >= m_finishedChunks.size()) {
+                break;
+            }
+            CityChunk& next = m_finishedChunks[m_finishedChunkIndex++];
+            auto awaited = m_awaitedChunks.find({next.gridX, next.gridZ});
+            if (awaited == m_awaitedChunks.end()) {
+                // the player moved away (or the cell was generated synchronously) before it finished
+                continue;
+            }
+            m_awaitedChunks.erase(awaited);
+            beginCommittingChunk(next.gridX, next.gridZ);
+            m_chunkInProgress = std::move(next);
+            m_nextChunkPiece = 0;
+        }
+        m_nextChunkPiece = commitChunkPieces(*m_chunkInProgress, m_nextChunkPiece, budget);
+        if (m_nextChunkPiece >= m_chunkInProgress->pieces.size()) {
+            m_chunkInProgress.reset();
         }
     }
+    if (m_finishedChunkIndex >= m_finishedChunks.size()) {
+        m_finishedChunks.clear();
+        m_finishedChunkIndex = 0;
+    }
 }
 
 void RealtimeScene::finish() {
-    for (const auto& object : m_objects) {
-        object->finish();
-    }
+    m_textures.finish();
+    m_instanceBatcher.finish();
+    m_lightBuffer.finish();
 }
 
 
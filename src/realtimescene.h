@@ -4,7 +4,9 @@
 
 // A class representing a scene to be rendered in real-time
 
+#include <limits>
 #include <map>
+#include <random>
 #include <ranges>
 
 #include "utils/scenedata.h"
@@ -12,24 +14,32 @@
 #include "objects/realtimeobject.h"
 #include "objects/collisionobject.h"
 #include "objects/playerobject.h"
+#include "collisiongrid.h"
+#include "instancebatcher.h"
+#include "lightbuffer.h"
+#include "texturemanager.h"
+#include "particlesystem.h"
+#include "entitystore.h"
+#include "citychunkgenerator.h"
+#include "chunkregistry.h"
+#include "scenecommandbuffer.h"
+#include "utils/uniformlocations.h"
 
 #include <unordered_set>
+// layout of the procedurally generated city; one grid cell is CITY_GRID_ROWS x CITY_GRID_COLS buildings
+#define CITY_GRID_SPACING 5.f
+#define CITY_GRID_ROWS 3
+#define CITY_GRID_COLS 3
 #define GRACE_PERIOD_MS 3000
 #define TIME_BETWEEN_SPAWNS_MS 5000
 #define PROBABILITY_OF_SPAWN 0.25
 #define TIME_TO_INCREMENT_SPAWN_S 15
 #define INCREMENT 0.05 //for probability of spawn
+// max city objects (floors/buildings) added to the scene per tick from chunks generated in the background
+#define CITY_COMMIT_BUDGET 10
+#define SKYBOX_TEXTURE "scenefiles/moretextures/stars.png"
 
 
-struct pair_hash {
-    template <typename T1, typename T2>
-    std::size_t operator()(const std::pair<T1, T2>& pair) const {
-        std::size_t h1 = std::hash<T1>{}(pair.first);
-        std::size_t h2 = std::hash<T2>{}(pair.second);
-        return h1 ^ (h2 << 1); // Combine hashes using XOR and bit shifting
-    }
-};
-
 //stuff required to make hashmaps work for vec2; we need both a way to check equality and a way to actually hash
 //we do this so we can store spawn locations as a hash from vec2's (grid) to vec3's (xyz)
 struct Vec2Hash {
@@ -60,7 +70,19 @@ public:
 
     /// Paints every object in the scene; to be called in paintGL
     void paintObjects();
-    void generateProceduralCity(int gridX, int gridZ, int rows, int cols, float spacing) ;
+
+    /// Counters from the last call to paintObjects
+    struct CullingStats {
+        /// Objects that passed culling and were sent to the GPU
+        int submitted = 0;
+        /// Objects rejected by frustum culling, including the ones rejected along with their whole grid cell
+        int culled = 0;
+        int cellsTested = 0;
+        int cellsCulled = 0;
+    };
+    const CullingStats& cullingStats() const;
+    /// Generates the city grid cell on the calling thread and adds all of it to the scene right away
+    void generateProceduralCity(int gridX, int gridZ);
     void spawnEnemiesInGrids();
 
     /// Convenience method for constructing and adding a new object to the scene
@@ -69,20 +91,47 @@ public:
     /// Insert new object into the scene.
     /// `object` should be a RealtimeObject or a subclass of RealtimeObject.
     /// If `object` is a subclass of CollisionObject, it will also be added to the collision objects list.
+    /// If it has a tick, it will also be added to the tick list.
     /// Returns a shared_ptr to the object.
     std::shared_ptr<RealtimeObject> addObject(std::unique_ptr<RealtimeObject> object);
+    /// Adds an object that's already in the scene to the tick list; only for RealtimeObject::wake
+    void registerTickObject(RealtimeObject* object);
 
-    /// Called every physics tick
+    /// Called every physics tick. Makes no GL calls, so the simulation can run without a context (see headlesssim.cpp)
+    /// Runs each phase once, in order: simulating the objects (which read the player's input and resolve their own
+    /// collisions as they move), the particles, spawning (the objects' queued commands, then enemies), compaction and
+    /// city streaming
     void tick(double elapsedSeconds);
 
+    /// Wall-clock time spent in each phase of the last call to tick, in seconds
+    struct TickStats {
+        /// The EntityStore's batched systems and ticking every object
+        double objectTick = 0.0;
+        double particles = 0.0;
+        /// Committing the command buffer, enemy spawning and difficulty scaling
+        double spawn = 0.0;
+        /// Removing freed objects from the object and collision lists
+        double compaction = 0.0;
+        double dynamicCity = 0.0;
+        /// Number of objects ticked
+        size_t objectsTicked = 0;
+    };
+    const TickStats& lastTickStats() const;
+    /// Seconds of simulation since the scene was created (the sum of every tick's elapsedSeconds)
+    double simTime() const;
+    /// Reseeds the generator used for enemy spawning, so runs with the same input are reproducible
+    void seedRandom(unsigned int seed);
+
     /// Sets the dimensions of the scene, and updates the camera's info accordingly
     void setDimensions(int width, int height);
 
     /// Updates the near and far planes of the scene, and updates the camera's info accordingly
     void updateSettings(float nearPlane, float farPlane);
 
-    /// Passes the shader ID to the scene (can't be done in the constructor because the shader isn't created yet)
-    void initShader(GLuint phongShader);
+    /// Passes the shader IDs to the scene (can't be done in the constructor because the shaders aren't created yet)
+    /// `instancedShader` is default_instanced.vert + default.frag, used when settings.instancedRendering is on
+    /// Also looks up the uniform locations of both programs and binds their Lights blocks; needs the GL context
+    void initShader(GLuint phongShader, GLuint instancedShader);
     /// Returns whether the shader has been initialized
     bool shaderInitialized() const;
 
@@ -94,16 +143,24 @@ public:
 
     /// Returns the meshes map of the scene
     const std::map<PrimitiveType, std::shared_ptr<PrimitiveMesh>>& meshes() const;
+    /// GL textures shared by the scene's objects, one per image file
+    TextureManager& textures();
 
     // Returns the collision objects list of the scene
     const std::vector<std::weak_ptr<CollisionObject>>& collisionObjects() const;
-    std::unordered_set<std::pair<int, int>, pair_hash> existingBuildings;
-    void removeGridObjects(int gridX, int gridZ, int rows, int cols);
+    /// Returns the broadphase grid used to find collision candidates; cells match the city grid cells
+    CollisionGrid& collisionGrid();
+    /// Returns the pool of cosmetic particles (e.g. projectile impacts), ticked and drawn by the scene
+    ParticleSystem& particles();
+    /// Objects to add or free once the current phase of tick is done; objects spawning other objects during their
+    /// tick must go through this rather than addObject
+    SceneCommandBuffer& commands();
+    /// Returns the store holding every object's transform, bounds and flags
+    const std::shared_ptr<EntityStore>& entities() const;
 
     // input events methods; currently called manually by realtime (ideally we'd have some callback system or something for this)
     float m_nearPlane;
     float m_farPlane;
-    static std::unordered_set<std::pair<int, int>, pair_hash> m_activeGrids;
     //std::vector<pair<int,int>> m_usedGrid;
 
 
@@ -131,6 +188,9 @@ public:
 private:
     RealtimeScene(int width, int height, float nearPlane, float farPlane, SceneGlobalData globalData, SceneCameraData cameraData,
                   std::map<PrimitiveType, std::shared_ptr<PrimitiveMesh>> meshes);
+    /// Decodes every texture the scene can use (the scene file's, plus the hard-coded enemy, city, skybox and
+    /// projectile ones) into the ImageCache in parallel, so spawning objects never waits on the disk
+    static void preloadTextures(const RenderData& renderData);
 
     //float m_nearPlane;
     //float m_farPlane;
@@ -146,23 +206,90 @@ private:
     // (it's fineeee, the meshes themselves aren't copied)
     std::map<PrimitiveType, std::shared_ptr<PrimitiveMesh>> m_meshes;
     std::optional<GLuint> m_phongShader;
+    std::optional<GLuint> m_instancedShader;
+    UniformLocations m_phongUniforms;
+    UniformLocations m_instancedUniforms;
+    /// The uniform locations of the program that the passUniform* helpers below currently write to
+    const UniformLocations* m_activeUniforms = nullptr;
+    InstanceBatcher m_instanceBatcher;
+    LightBuffer m_lightBuffer;
+    TextureManager m_textures;
+
+    /// Binds `shader` and passes the uniforms shared by every object (camera, global coefficients);
+    /// lights come from m_lightBuffer, which must already be up to date
+    void useShaderWithSceneUniforms(GLuint shader, const UniformLocations& uniforms);
+    /// Fills m_visibleObjects with the renderable objects that pass frustum culling.
+    /// Whole grid cells from m_chunks are tested first, and only the objects of the accepted cells are visited, so
+    /// rejected cells cost nothing per object; objects outside the grid cells (m_looseObjects) are tested one by one
+    void collectVisibleObjects();
+    /// Picks the level of detail of every visible object from its projected size
+    void selectLODs();
+    /// Objects that survived culling this frame (only valid during paintObjects)
+    std::vector<RealtimeObject*> m_visibleObjects;
+    CullingStats m_cullingStats;
+
+    /// Draws each object with its own draw call (the pre-instancing path)
+    void paintObjectsIndividually();
+    /// Groups objects by mesh and texture and draws each group with a single instanced draw call
+    void paintObjectsInstanced();
+    /// Draws only the particles with the instanced shader (paintObjectsInstanced already includes them)
+    void paintParticles();
+
+    ParticleSystem m_particles;
+    SceneCommandBuffer m_commands;
+    std::shared_ptr<EntityStore> m_entities;
+    /// Runs the EntityStore's batched systems and ticks every object in the tick list once. Objects spawned during the
+    /// pass go through m_commands, so they're first ticked on the next step; objects that went to sleep are dropped
+    /// from the list afterwards
+    void tickObjects(double elapsedSeconds);
+    /// Objects with a tick that aren't asleep (see RealtimeObject::hasTick); owned by m_objects, and removed from here
+    /// by compactObjects before they're freed
+    std::vector<RealtimeObject*> m_tickObjects;
+    /// Objects that don't belong to a city grid cell in m_chunks (the player, skybox, enemies, projectiles...), so
+    /// culling has to visit them individually; owned by m_objects, and removed from here by compactObjects
+    std::vector<RealtimeObject*> m_looseObjects;
+    /// Adds the object to m_objects, the collision list and the tick list, but not to m_looseObjects; for objects that
+    /// belong to a grid cell. Returns a shared_ptr to the object, or nullptr if it's null
+    std::shared_ptr<RealtimeObject> insertObject(std::unique_ptr<RealtimeObject> object);
+    /// Removes freed objects from m_tickObjects, m_looseObjects and m_objects, and expired ones from m_collisionObjects
+    void compactObjects();
 
     std::shared_ptr<bool> m_taken_damage;
 
-    // helper functions for passing uniforms to the shader (and checking for -1 locations)
-    void passUniformMat4(const char* name, const glm::mat4& mat);
-    void passUniformMat3(const char* name, const glm::mat3& mat);
-    void passUniformFloat(const char* name, float value);
-    void passUniformInt(const char* name, int value);
-    void passUniformVec3(const char* name, const glm::vec3& vec);
-    void passUniformVec3Array(const char* name, const std::vector<glm::vec3>& vecs);
-    void passUniformLightArray(const char* name, std::shared_ptr<std::vector<SceneLightData>> lights);
-    void passUniformLight(const char* name, SceneLightData type);
-
-    GLint getUniformLocation(const char* name, bool checkValidLoc = true) const;
-
-    /// convert enum class LightType to the corresponding uniform value
-    static GLuint lightTypeToUniform(LightType type);
+    CollisionGrid m_collisionGrid;
+    /// Adds the object to the collision objects list and the collision grid
+    void registerCollisionObject(const std::shared_ptr<CollisionObject>& object);
+
+    /// The loaded city grid cells, with the objects and buildings that belong to each
+    ChunkRegistry m_chunks;
+    /// Generates the city grid cells around the player in the background (see updateDynamicCity)
+    std::unique_ptr<CityChunkGenerator> m_chunkGenerator;
+    /// Cells requested from m_chunkGenerator that should still be committed when they arrive
+    std::unordered_set<std::pair<int, int>, pair_hash> m_awaitedChunks;
+    /// Chunks taken from m_chunkGenerator; the ones before m_finishedChunkIndex have already been handled
+    std::vector<CityChunk> m_finishedChunks;
+    size_t m_finishedChunkIndex = 0;
+    /// The chunk currently being added to the scene, and the index of its next piece to add
+    std::optional<CityChunk> m_chunkInProgress;
+    size_t m_nextChunkPiece = 0;
+    glm::vec3 m_lastPlayerPosition = glm::vec3(0.f);
+    /// Direction (in xz) the player last moved in; chunks in this direction are generated first
+    glm::vec2 m_playerHeading = glm::vec2(0.f);
+    /// Marks the cell as active and registers its enemy spawn location
+    void beginCommittingChunk(int gridX, int gridZ);
+    /// Adds up to `budget` objects from `chunk` to the scene, starting at `firstPiece`, and subtracts the number added
+    /// from `budget` (buildings that already exist are skipped without counting); returns the index of the first piece
+    /// that wasn't handled
+    size_t commitChunkPieces(const CityChunk& chunk, size_t firstPiece, int& budget);
+    /// Adds finished background chunks to the scene, at most CITY_COMMIT_BUDGET objects per call
+    void commitFinishedChunks();
+
+    // helper functions for passing uniforms to the active shader
+    void passUniformMat4(Uniform uniform, const glm::mat4& mat);
+    void passUniformMat3(Uniform uniform, const glm::mat3& mat);
+    void passUniformFloat(Uniform uniform, float value);
+    void passUniformInt(Uniform uniform, int value);
+    void passUniformVec3(Uniform uniform, const glm::vec3& vec);
 
     //Skybox stuff
     std::shared_ptr<RealtimeObject> m_skyboxObject;
@@ -178,16 +305,23 @@ private:
 
     void addEnemy(glm::vec3 position);
 
+    // all times below are in seconds of simulation time (m_simTime), not wall-clock time, so that the simulation
+    // behaves the same no matter how fast it's run
+    double m_simTime = 0.0;
+    TickStats m_tickStats;
+    std::mt19937 m_rng{std::random_device{}()};
+
     //grace period for when you spawn in
-    std::chrono::time_point<std::chrono::steady_clock> m_enemy_spawn_start;
+    double m_enemy_spawn_start = 0.0;
 
-    std::chrono::time_point<std::chrono::steady_clock> m_time_last_spawn;
+    // start at -infinity so the first check passes right away
+    double m_time_last_spawn = -std::numeric_limits<double>::infinity();
 
     //hash map from grid x, z to xyz to spawn enemy at
     std::unordered_map<glm::vec2,glm::vec3, Vec2Hash, Vec2Equal> m_enemy_spawn_locations;
 
     int current_difficulty_scaling = 0;
-    std::chrono::time_point<std::chrono::steady_clock> m_time_last_scaling;
+    double m_time_last_scaling = -std::numeric_limits<double>::infinity();
 };
 
 
@@ -0,0 +1,42 @@
+#include "scenecommandbuffer.h"
+#include "realtimescene.h"
+#include "objects/realtimeobject.h"
+
+SceneCommandBuffer::SceneCommandBuffer() {
+    m_pending.reserve(SCENE_COMMAND_RESERVE);
+    m_applying.reserve(SCENE_COMMAND_RESERVE);
+}
+
+void SceneCommandBuffer::spawn(SpawnFunction spawnFunction) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.push_back(Command{std::move(spawnFunction), {}});
+}
+
+void SceneCommandBuffer::free(const std::shared_ptr<RealtimeObject>& object) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.push_back(Command{nullptr, object});
+}
+
+void SceneCommandBuffer::commit(RealtimeScene& scene) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(m_pending, m_applying);
+    }
+    if (m_applying.empty()) {
+        return;
+    }
+    std::shared_ptr<RealtimeScene> sceneShared = scene.shared_from_this();
+    for (Command& command : m_applying) {
+        if (command.spawn) {
+            scene.addObject(command.spawn(sceneShared));
+        } else if (std::shared_ptr<RealtimeObject> object = command.free.lock()) {
+            object->queueFree();
+        }
+    }
+    m_applying.clear();
+}
+
+size_t SceneCommandBuffer::size() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
@@ -0,0 +1,55 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class RealtimeObject;
+class RealtimeScene;
+
+// commands the buffer has room for before its first commit; the capacity is kept across commits after that
+#define SCENE_COMMAND_RESERVE 64
+
+/// Builds an object to add to the scene; run on the main thread when the command buffer is committed
+typedef std::function<std::unique_ptr<RealtimeObject>(const std::shared_ptr<RealtimeScene>& scene)> SpawnFunction;
+
+/// Records objects to add to and remove from the scene while a phase of RealtimeScene::tick is running, so the object
+/// lists don't change under the phase; RealtimeScene applies them all at once between phases.
+/// Any number of threads may record commands at once. Spawns are recorded as functions rather than objects, since
+/// creating an object creates its entity, which is only safe on the main thread outside of the passes over the
+/// EntityStore
+class SceneCommandBuffer {
+public:
+    SceneCommandBuffer();
+
+    /// Queues an object to be built and added to the scene
+    void spawn(SpawnFunction spawnFunction);
+    /// Queues an object to be freed (see RealtimeObject::queueFree). Only a weak reference is kept, so objects that
+    /// are destroyed before the next commit are skipped
+    void free(const std::shared_ptr<RealtimeObject>& object);
+
+    /// Applies the queued commands in the order they were recorded: spawns are added with RealtimeScene::addObject,
+    /// frees are queued for the next compaction. Commands recorded while committing are left for the next commit.
+    /// Only call from the main thread
+    void commit(RealtimeScene& scene);
+    /// Number of commands waiting for the next commit
+    size_t size();
+
+private:
+    struct Command {
+        /// Empty for frees
+        SpawnFunction spawn;
+        std::weak_ptr<RealtimeObject> free;
+    };
+
+    std::mutex m_mutex;
+    std::vector<Command> m_pending;
+    /// Swapped with m_pending on commit, so recording never waits on the commands being applied and both vectors keep
+    /// their capacity
+    std::vector<Command> m_applying;
+};
+
+#pragma clang diagnostic pop
@@ -10,6 +10,24 @@ struct Settings {
     float farPlane = 1;
     bool perPixelFilter = false;
     bool kernelBasedFilter = false;
+    /// Draw objects that share a mesh and texture with one instanced draw call instead of one draw call each
+    bool instancedRendering = true;
+    /// Skip objects (and whole city grid cells) that are outside the camera's view frustum
+    bool frustumCulling = true;
+    /// Upload meshes as welded vertices plus an index buffer instead of plain triangle lists; only takes effect when
+    /// the mesh buffers are next updated
+    bool indexedMeshes = true;
+    /// Draw objects that are small on screen with coarser tessellations of their mesh
+    bool levelOfDetail = true;
+    /// Store the vertices of the unit primitives as 16-byte PackedVertex instead of 8 floats; only takes effect for
+    /// meshes whose buffers haven't been allocated yet
+    bool packedVertices = true;
+    /// Worker threads generating city chunks in the background; 0 generates them on the main thread as they're needed
+    int cityGenerationThreads = 2;
+    /// Most threads used to tessellate a single mesh (see PrimitiveMesh::generateWedges); 0 uses every hardware thread
+    int tessellationThreads = 0;
+    /// Decoded images not used by any object are evicted from the image cache once it holds more than this
+    int imageCacheBudgetMB = 128;
 };
 
 
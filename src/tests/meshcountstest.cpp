@@ -0,0 +1,90 @@
+// Checks every primitive's cached vertex and index counts, and the counts its draw calls use, against the vertex and
+// index data it generated, for a range of shape parameters and on one thread and several. Needs no GL context.
+//
+// usage: mesh_counts_test
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "meshes/primitivemesh.h"
+#include "settings.h"
+
+#define TEST_THREADS 4
+
+int failures = 0;
+
+void check(bool condition, const std::string& what, const std::string& mesh, int param1, int param2) {
+    if (!condition) {
+        std::cerr << "FAIL " << mesh << " (" << param1 << ", " << param2 << "): " << what << std::endl;
+        failures++;
+    }
+}
+
+void checkMesh(const PrimitiveMesh& mesh, const std::string& name, int param1, int param2) {
+    const std::vector<float>& vertices = mesh.vertexData();
+    const std::vector<float>& indexedVertices = mesh.indexedVertexData();
+    const std::vector<GLuint>& indices = mesh.indices();
+    size_t numVertices = vertices.size() / FLOATS_PER_VERTEX;
+    size_t numIndexedVertices = indexedVertices.size() / FLOATS_PER_VERTEX;
+
+    check(!vertices.empty(), "no vertex data", name, param1, param2);
+    check(vertices.size() % (3 * FLOATS_PER_VERTEX) == 0, "vertex data isn't a whole number of triangles", name,
+          param1, param2);
+    check(indexedVertices.size() % FLOATS_PER_VERTEX == 0, "indexed vertex data isn't a whole number of vertices",
+          name, param1, param2);
+    check((size_t) mesh.vertexCount() == numVertices, "vertexCount() is " + std::to_string(mesh.vertexCount()) +
+          ", vertex data has " + std::to_string(numVertices), name, param1, param2);
+    check((size_t) mesh.indexCount() == indices.size(), "indexCount() is " + std::to_string(mesh.indexCount()) +
+          ", index data has " + std::to_string(indices.size()), name, param1, param2);
+    check(indices.size() == numVertices, "index data doesn't have one index per triangle list vertex", name, param1,
+          param2);
+    check((size_t) mesh.drawCount(false) == numVertices, "glDrawArrays count is " +
+          std::to_string(mesh.drawCount(false)) + ", vertex data has " + std::to_string(numVertices), name, param1,
+          param2);
+    check((size_t) mesh.drawCount(true) == indices.size(), "glDrawElements count is " +
+          std::to_string(mesh.drawCount(true)) + ", index data has " + std::to_string(indices.size()), name, param1,
+          param2);
+
+    // the indexed mesh has to describe exactly the same triangles as the triangle list
+    for (size_t i = 0; i < indices.size() && i < numVertices; i++) {
+        if (indices[i] >= numIndexedVertices) {
+            check(false, "index " + std::to_string(i) + " is out of range", name, param1, param2);
+            return;
+        }
+        if (std::memcmp(&indexedVertices[indices[i] * FLOATS_PER_VERTEX], &vertices[i * FLOATS_PER_VERTEX],
+                        FLOATS_PER_VERTEX * sizeof(float)) != 0) {
+            check(false, "index " + std::to_string(i) + " refers to the wrong vertex", name, param1, param2);
+            return;
+        }
+    }
+}
+
+int main() {
+    std::vector<std::pair<std::string, PrimitiveType>> types = {
+            {"cube", PrimitiveType::PRIMITIVE_CUBE},
+            {"sphere", PrimitiveType::PRIMITIVE_SPHERE},
+            {"cylinder", PrimitiveType::PRIMITIVE_CYLINDER},
+            {"cone", PrimitiveType::PRIMITIVE_CONE},
+            {"skybox", PrimitiveType::PRIMITIVE_SKYBOX},
+    };
+    std::vector<int> params = {1, 2, 3, 5, 8, 20, 37, 100};
+    int checked = 0;
+    for (int threads : {1, TEST_THREADS}) {
+        settings.tessellationThreads = threads;
+        for (int param1 : params) {
+            for (int param2 : params) {
+                auto meshes = PrimitiveMesh::initMeshes(param1, param2);
+                for (const auto& [name, type] : types) {
+                    const PrimitiveMesh& mesh = *meshes.at(type);
+                    for (int level = 0; level < mesh.lodCount(); level++) {
+                        checkMesh(mesh.lod(level), name + " lod " + std::to_string(level), param1, param2);
+                        checked++;
+                    }
+                }
+            }
+        }
+    }
+    std::cout << checked << " meshes checked, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+// Ticks a headless scene and checks that every object is ticked exactly once per step: objects added before the step,
+// objects spawned through the command buffer during it (which aren't ticked until the next step), objects freed
+// through it, and objects that go to sleep and are woken again. Also checks that frees of objects destroyed before the
+// commit are skipped. Needs no GL context.
+//
+// usage: tick_test [sceneFilePath]
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "realtimescene.h"
+#include "objects/realtimeobject.h"
+#include "settings.h"
+
+#define TEST_STEPS 120
+#define TEST_COUNTERS 20
+#define TEST_SEED 1230
+// the first counter spawns another one on each of its ticks before this step
+#define SPAWN_STEPS 5
+// counters with an index divisible by SLEEP_EVERY go to sleep on this step, and are woken on WAKE_STEP
+#define SLEEP_STEP 30
+#define WAKE_STEP 60
+#define SLEEP_EVERY 3
+// counters with an index divisible by FREE_EVERY free themselves through the command buffer on this step
+#define FREE_STEP 90
+#define FREE_EVERY 4
+
+/// What the test knows about each counter; outlives the counter itself
+struct CounterRecord {
+    int index;
+    int ticks = 0;
+    /// nullptr once the counter has been destroyed
+    RealtimeObject* object = nullptr;
+};
+
+std::vector<std::unique_ptr<CounterRecord>> records;
+int step = 0;
+
+/// Counts its ticks in its CounterRecord, and spawns, sleeps or frees itself on the steps above
+class CounterObject : public RealtimeObject {
+public:
+    CounterObject(const std::shared_ptr<RealtimeScene>& scene, int index) :
+    RealtimeObject(RenderShapeData{ScenePrimitive{PrimitiveType::PRIMITIVE_CUBE, SceneMaterial{}},
+                                   glm::translate(glm::mat4(1.f), glm::vec3((float) index, 1000.f, 0.f))}, scene) {
+        records.push_back(std::make_unique<CounterRecord>());
+        m_record = records.back().get();
+        m_record->index = index;
+        m_record->object = this;
+    }
+
+    ~CounterObject() override {
+        m_record->object = nullptr;
+    }
+
+    bool hasTick() const override {
+        return true;
+    }
+
+    void tick(double elapsedSeconds) override {
+        m_record->ticks++;
+        int index = m_record->index;
+        if (index == 0 && step < SPAWN_STEPS) {
+            int childIndex = (int) records.size();
+            scene()->commands().spawn([childIndex](const std::shared_ptr<RealtimeScene>& scene) {
+                return std::make_unique<CounterObject>(scene, childIndex);
+            });
+        }
+        if (step == SLEEP_STEP && index % SLEEP_EVERY == 0) {
+            sleep();
+        }
+        if (step == FREE_STEP && index % FREE_EVERY == 0) {
+            std::shared_ptr<RealtimeScene> scene = this->scene();
+            for (const std::shared_ptr<RealtimeObject>& object : scene->m_objects) {
+                if (object.get() == this) {
+                    scene->commands().free(object);
+                }
+            }
+        }
+    }
+
+private:
+    CounterRecord* m_record;
+};
+
+int main(int argc, char* argv[]) {
+    settings.farPlane = 100.f;
+    settings.nearPlane = 0.05f;
+    settings.shapeParameter1 = 5;
+    settings.shapeParameter2 = 5;
+    settings.sceneFilePath = argc > 1 ? argv[1] : "scenefiles/final/procedural_city.json";
+
+    auto meshes = PrimitiveMesh::initMeshes(settings.shapeParameter1, settings.shapeParameter2);
+    auto scene = RealtimeScene::init(1, 1, settings.sceneFilePath, settings.nearPlane, settings.farPlane, meshes,
+                                     std::make_shared<bool>(false));
+    if (!scene) {
+        return 1;
+    }
+    scene->seedRandom(TEST_SEED);
+    for (int i = 0; i < TEST_COUNTERS; i++) {
+        scene->addObject(std::make_unique<CounterObject>(scene, i));
+    }
+
+    int failures = 0;
+    // a free recorded for an object that's gone by the commit must be skipped rather than touch the object
+    auto destroyedBeforeCommit = std::make_shared<CounterObject>(scene, -1);
+    scene->commands().free(destroyedBeforeCommit);
+    destroyedBeforeCommit.reset();
+
+    for (step = 0; step < TEST_STEPS; step++) {
+        if (step == WAKE_STEP) {
+            for (const auto& record : records) {
+                if (record->object && record->object->isAsleep()) {
+                    record->object->wake();
+                }
+            }
+        }
+        // every counter that's in the scene and awake when the step starts gets exactly one more tick
+        size_t existing = records.size();
+        std::vector<int> expected(existing);
+        int expectedTicked = 0;
+        for (size_t i = 0; i < existing; i++) {
+            bool ticks = records[i]->object && !records[i]->object->isAsleep();
+            expected[i] = records[i]->ticks + (ticks ? 1 : 0);
+            expectedTicked += ticks ? 1 : 0;
+        }
+
+        scene->tick(1.0 / 60.0);
+
+        for (size_t i = 0; i < records.size(); i++) {
+            // counters spawned during the step are first ticked on the next one
+            int want = i < existing ? expected[i] : 0;
+            if (records[i]->ticks != want) {
+                std::cerr << "FAIL step " << step << ": counter " << i << " has " << records[i]->ticks
+                          << " ticks, expected " << want << std::endl;
+                failures++;
+            }
+        }
+        // the player and enemies are ticked too
+        if (scene->lastTickStats().objectsTicked < (size_t) expectedTicked) {
+            std::cerr << "FAIL step " << step << ": " << scene->lastTickStats().objectsTicked
+                      << " objects ticked, but " << expectedTicked << " counters should have been" << std::endl;
+            failures++;
+        }
+    }
+
+    size_t freed = 0;
+    for (const auto& record : records) {
+        freed += record->object ? 0 : 1;
+    }
+    std::cout << records.size() << " counters over " << TEST_STEPS << " steps (" << freed << " freed), " << failures
+              << " failures" << std::endl;
+    return failures == 0 && freed > 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include <utility>
+#include "texturemanager.h"
+#include "utils/imagecache.h"
+
+GLTexture::GLTexture(std::shared_ptr<const Image> image, std::shared_ptr<std::vector<GLuint>> pendingDeletes)
+        : m_image(std::move(image)), m_pendingDeletes(std::move(pendingDeletes)) {}
+
+GLTexture::~GLTexture() {
+    if (m_id != 0) {
+        m_pendingDeletes->push_back(m_id);
+    }
+}
+
+GLuint GLTexture::id() {
+    if (m_id != 0 || !m_image) {
+        return m_id;
+    }
+    glGenTextures(1, &m_id);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_image->width, m_image->height,
+                 0, GL_RGBA, GL_UNSIGNED_BYTE, m_image->data.get());
+    // buildings are often seen from far away at a steep angle, which aliases badly without mipmaps
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    m_image.reset();
+    return m_id;
+}
+
+bool GLTexture::uploaded() const {
+    return m_id != 0;
+}
+
+TextureManager::TextureManager() : m_pendingDeletes(std::make_shared<std::vector<GLuint>>()) {}
+
+std::shared_ptr<GLTexture> TextureManager::acquire(const std::string& path) {
+    std::weak_ptr<GLTexture>& entry = m_textures[path];
+    if (auto texture = entry.lock()) {
+        return texture;
+    }
+    std::shared_ptr<const Image> image = ImageCache::global().get(path);
+    if (!image) {
+        return nullptr;
+    }
+    auto texture = std::make_shared<GLTexture>(image, m_pendingDeletes);
+    entry = texture;
+    return texture;
+}
+
+void TextureManager::collectGarbage() {
+    if (!m_pendingDeletes->empty()) {
+        glDeleteTextures((GLsizei) m_pendingDeletes->size(), m_pendingDeletes->data());
+        m_pendingDeletes->clear();
+    }
+    std::erase_if(m_textures, [](const auto& entry) { return entry.second.expired(); });
+}
+
+size_t TextureManager::size() const {
+    size_t live = 0;
+    for (const auto& [path, texture] : m_textures) {
+        if (!texture.expired()) {
+            live++;
+        }
+    }
+    return live;
+}
+
+void TextureManager::finish() {
+    collectGarbage();
+    for (auto& [path, weakTexture] : m_textures) {
+        if (auto texture = weakTexture.lock(); texture && texture->m_id != 0) {
+            glDeleteTextures(1, &texture->m_id);
+            texture->m_id = 0;
+        }
+    }
+}
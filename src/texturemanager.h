@@ -0,0 +1,56 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-nodiscard"
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <GL/glew.h>
+#include "utils/imagereader.h"
+
+/// A texture shared by every object that uses the same image file. Uploaded (with mipmaps) the first time it's bound;
+/// when the last object using it goes away, the GL texture is queued for deletion (see TextureManager::collectGarbage)
+class GLTexture {
+public:
+    GLTexture(std::shared_ptr<const Image> image, std::shared_ptr<std::vector<GLuint>> pendingDeletes);
+    ~GLTexture();
+    GLTexture(const GLTexture&) = delete;
+    GLTexture& operator=(const GLTexture&) = delete;
+
+    /// Returns the GL texture, uploading the image first if it hasn't been yet; needs the GL context
+    GLuint id();
+    bool uploaded() const;
+
+private:
+    friend class TextureManager;
+
+    /// Released once uploaded
+    std::shared_ptr<const Image> m_image;
+    GLuint m_id = 0;
+    /// Shared with the TextureManager; objects (and so their textures) are destroyed during tick, when there's no GL
+    /// context, so the texture can't be deleted right away
+    std::shared_ptr<std::vector<GLuint>> m_pendingDeletes;
+};
+
+/// Hands out one refcounted GLTexture per image file, so objects with the same texture share a single upload
+class TextureManager {
+public:
+    TextureManager();
+
+    /// Returns the texture for `path`, getting the image from the ImageCache if no live texture exists for that path;
+    /// nullptr if the image can't be loaded
+    std::shared_ptr<GLTexture> acquire(const std::string& path);
+    /// Deletes the GL textures that are no longer used by any object; needs the GL context
+    void collectGarbage();
+    /// Number of textures currently in use
+    size_t size() const;
+    /// Deletes every GL texture, including the ones still in use; for when the GL context is going away
+    void finish();
+
+private:
+    std::unordered_map<std::string, std::weak_ptr<GLTexture>> m_textures;
+    std::shared_ptr<std::vector<GLuint>> m_pendingDeletes;
+};
+
+#pragma clang diagnostic pop
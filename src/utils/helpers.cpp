@@ -33,6 +33,26 @@ void helpers::passUniformVec3Array(GLuint shader_program, const char* name, cons
     glUniform3fv(getUniformLocation(shader_program, name), (GLint) vecs.size(), &vecs[0][0]);
 }
 
+void helpers::passUniformMat4(GLint loc, const glm::mat4& mat) {
+    glUniformMatrix4fv(loc, 1, GL_FALSE, &mat[0][0]);
+}
+
+void helpers::passUniformMat3(GLint loc, const glm::mat3& mat) {
+    glUniformMatrix3fv(loc, 1, GL_FALSE, &mat[0][0]);
+}
+
+void helpers::passUniformFloat(GLint loc, float value) {
+    glUniform1f(loc, value);
+}
+
+void helpers::passUniformInt(GLint loc, int value) {
+    glUniform1i(loc, value);
+}
+
+void helpers::passUniformVec3(GLint loc, const glm::vec3& vec) {
+    glUniform3fv(loc, 1, &vec[0]);
+}
+
 glm::vec3 helpers::projectAontoB(const glm::vec3& a, const glm::vec3& b) {
     float dotBB = glm::dot(b, b);
     if (dotBB < EPSILON) {
@@ -15,5 +15,12 @@ namespace helpers {
     void passUniformVec3(GLuint shader_program, const char* name, const glm::vec3& vec);
     void passUniformVec3Array(GLuint shader_program, const char* name, const std::vector<glm::vec3>& vecs);
 
+    // same as above, but with a location that was already looked up (see UniformLocations)
+    void passUniformMat4(GLint loc, const glm::mat4& mat);
+    void passUniformMat3(GLint loc, const glm::mat3& mat);
+    void passUniformFloat(GLint loc, float value);
+    void passUniformInt(GLint loc, int value);
+    void passUniformVec3(GLint loc, const glm::vec3& vec);
+
     glm::vec3 projectAontoB(const glm::vec3& a, const glm::vec3& b);
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "imagecache.h"
+#include "settings.h"
+
+ImageCache& ImageCache::global() {
+    static ImageCache cache((size_t) settings.imageCacheBudgetMB * 1024 * 1024);
+    return cache;
+}
+
+ImageCache::ImageCache(size_t budgetBytes) : m_budget(budgetBytes) {}
+
+std::shared_ptr<const Image> ImageCache::get(const std::string& path) {
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_entries.find(path);
+        if (it != m_entries.end()) {
+            m_stats.hits++;
+            // move to the front
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return it->second->image;
+        }
+        m_stats.misses++;
+    }
+
+    std::shared_ptr<const Image> image = loadImageFromFile(path);
+    if (!image) {
+        return nullptr;
+    }
+    std::lock_guard lock(m_mutex);
+    return insert(path, std::move(image));
+}
+
+void ImageCache::preload(const std::vector<std::string>& paths, int numThreads) {
+    std::vector<std::string> toLoad;
+    {
+        std::lock_guard lock(m_mutex);
+        for (const std::string& path : paths) {
+            if (!m_entries.contains(path) && std::find(toLoad.begin(), toLoad.end(), path) == toLoad.end()) {
+                toLoad.push_back(path);
+            }
+        }
+    }
+
+    // each thread takes the next path that nobody has started on yet
+    std::atomic<size_t> next = 0;
+    auto work = [this, &toLoad, &next]() {
+        for (size_t i = next++; i < toLoad.size(); i = next++) {
+            std::shared_ptr<const Image> image = loadImageFromFile(toLoad[i]);
+            if (image) {
+                std::lock_guard lock(m_mutex);
+                m_stats.misses++;
+                insert(toLoad[i], std::move(image));
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    size_t numWorkers = std::min(toLoad.size(), (size_t) std::max(numThreads, 1));
+    for (size_t i = 1; i < numWorkers; i++) {
+        threads.emplace_back(work);
+    }
+    // the calling thread would just be waiting anyway, so it decodes too
+    work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void ImageCache::setBudget(size_t budgetBytes) {
+    std::lock_guard lock(m_mutex);
+    m_budget = budgetBytes;
+    evict();
+}
+
+size_t ImageCache::budget() const {
+    std::lock_guard lock(m_mutex);
+    return m_budget;
+}
+
+ImageCache::Stats ImageCache::stats() const {
+    std::lock_guard lock(m_mutex);
+    return m_stats;
+}
+
+std::shared_ptr<const Image> ImageCache::insert(const std::string& path, std::shared_ptr<const Image> image) {
+    auto it = m_entries.find(path);
+    if (it != m_entries.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return it->second->image;
+    }
+    size_t bytes = image->pixelCount() * sizeof(RGBA);
+    m_lru.push_front(Entry{path, image, bytes});
+    m_entries[path] = m_lru.begin();
+    m_stats.bytes += bytes;
+    m_stats.entries++;
+    // the new image is still referenced by `image`, so this can't evict it
+    evict();
+    return image;
+}
+
+void ImageCache::evict() {
+    auto it = m_lru.end();
+    while (m_stats.bytes > m_budget && it != m_lru.begin()) {
+        --it;
+        // the only reference is ours, so no object or texture upload is using the image
+        if (it->image.use_count() == 1) {
+            m_stats.bytes -= it->bytes;
+            m_stats.entries--;
+            m_stats.evictions++;
+            m_entries.erase(it->path);
+            it = m_lru.erase(it);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "utils/imagereader.h"
+
+/// Decoded images keyed by file path, kept around so reloading a texture doesn't hit the disk again.
+/// The cache has a byte budget: when it's over budget, the least recently used images that nobody else holds a
+/// reference to are evicted. Images still referenced elsewhere are never evicted, so the cache can temporarily exceed
+/// its budget if that many images are in use at once.
+/// Safe to use from multiple threads; images are decoded outside the lock, so loads of different files don't wait on
+/// each other
+class ImageCache {
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        /// Size of the decoded pixel data of every cached image
+        size_t bytes = 0;
+        size_t entries = 0;
+    };
+
+    /// The cache shared by every scene; its budget is settings.imageCacheBudgetMB
+    static ImageCache& global();
+
+    explicit ImageCache(size_t budgetBytes);
+
+    /// Returns the image at `path`, loading it from disk if it isn't cached; nullptr if it can't be loaded
+    std::shared_ptr<const Image> get(const std::string& path);
+    /// Decodes every image in `paths` that isn't cached yet on `numThreads` threads, and waits for them to finish.
+    /// Preloaded images aren't referenced by anything yet, so preloading more than the budget evicts the earlier ones
+    void preload(const std::vector<std::string>& paths, int numThreads);
+    /// Evicts right away if the new budget is smaller than what's cached
+    void setBudget(size_t budgetBytes);
+    size_t budget() const;
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::string path;
+        std::shared_ptr<const Image> image;
+        size_t bytes;
+    };
+
+    /// Evicts unreferenced images, least recently used first, until the cache fits in its budget (or nothing else
+    /// can be evicted)
+    void evict();
+    /// Adds a freshly decoded image, unless another thread cached the same path while it was being decoded; returns
+    /// whichever image ends up cached. Must be called with m_mutex held
+    std::shared_ptr<const Image> insert(const std::string& path, std::shared_ptr<const Image> image);
+
+    /// Most recently used at the front
+    std::list<Entry> m_lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_entries;
+    size_t m_budget;
+    Stats m_stats;
+    mutable std::mutex m_mutex;
+};
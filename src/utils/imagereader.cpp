@@ -1,16 +1,49 @@
 #include "imagereader.h"
+#include "textureblobcache.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "utils/stb_image.h"
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+// stb_image's 4 channel output is laid out exactly like an array of RGBA, so Image can use its buffer as is
+static_assert(sizeof(RGBA) == 4 && alignof(RGBA) == 1, "RGBA must match stb_image's 4 channel pixel layout");
+
+void ImagePixelDeleter::operator()(RGBA* pixels) const {
+#ifndef _WIN32
+    if (mapping) {
+        munmap(mapping, mappingBytes);
+        return;
+    }
+#endif
+    stbi_image_free(pixels);
+}
+
+size_t Image::pixelCount() const {
+    return (size_t) width * height;
+}
+
+std::unique_ptr<Image> loadImageFromFile(const std::string& file) {
+    if (std::unique_ptr<Image> cached = loadTextureBlob(file)) {
+        return cached;
+    }
+    std::unique_ptr<Image> image = decodeImageFile(file);
+    if (image) {
+        storeTextureBlob(file, *image);
+    }
+    return image;
+}
+
 // this function is copied from the projects 3/4 stencil, but we ported it from Qt to stb_image
 /**
- * @brief Stores the image specified from the input file in this class's
- * `std::vector<RGBA> m_image`.
+ * @brief Decodes the image specified from the input file; the returned Image takes ownership of stb_image's buffer,
+ * so the pixels are never copied.
  * @param file: file path to an image
  * @return Pointer to the image if successfully loads image, nullptr otherwise.
  */
-std::unique_ptr<Image> loadImageFromFile(const std::string& file) {
+std::unique_ptr<Image> decodeImageFile(const std::string& file) {
     int width, height;
 
     // 4 tells stb to force load the image with an alpha channel
@@ -24,18 +57,7 @@ std::unique_ptr<Image> loadImageFromFile(const std::string& file) {
     std::unique_ptr<Image> myImage = std::make_unique<Image>();
     myImage->width = width;
     myImage->height = height;
-    myImage->data.resize(width * height);
-
-    for (int i = 0; i < width * height; ++i) {
-        myImage->data[i] = {
-                imgData[4 * i + 0],
-                imgData[4 * i + 1],
-                imgData[4 * i + 2],
-                imgData[4 * i + 3]
-        };
-    }
-
-    // we copied the image data out, so we can free the stb image data
-    stbi_image_free(imgData);
+    // the image frees the stb image data when it's destroyed
+    myImage->data = std::unique_ptr<RGBA[], ImagePixelDeleter>(reinterpret_cast<RGBA*>(imgData));
     return myImage;
 }
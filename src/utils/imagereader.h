@@ -5,10 +5,26 @@
 #include <memory>
 #include <vector>
 
+/// Frees an Image's pixel data, which was either allocated by stb_image or mapped from a texture blob
+struct ImagePixelDeleter {
+    /// The whole file mapping the pixels are part of, if they come from a memory mapped texture blob (see
+    /// textureblobcache.h); null if stb_image allocated them
+    void* mapping = nullptr;
+    size_t mappingBytes = 0;
+
+    void operator()(RGBA* pixels) const;
+};
+
 struct Image {
-    std::vector<RGBA> data;
+    /// width * height pixels, row by row. This is the buffer stb_image decoded into (or the mapped blob), not a copy
+    std::unique_ptr<RGBA[], ImagePixelDeleter> data;
     int width;
     int height;
+
+    size_t pixelCount() const;
 };
 
+/// Returns the image from the texture blob cache if it's there, otherwise decodes the file and adds it to the cache
 std::unique_ptr<Image> loadImageFromFile(const std::string& file);
+/// Always decodes the file, bypassing the texture blob cache
+std::unique_ptr<Image> decodeImageFile(const std::string& file);
@@ -0,0 +1,162 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include "textureblobcache.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    /// Start of every blob; followed by the source path (pathLength bytes) and then the width * height pixels
+    struct BlobHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceModified;
+        uint32_t width;
+        uint32_t height;
+        uint32_t pathLength;
+        uint32_t padding;
+    };
+
+    const char BLOB_MAGIC[4] = {'T', 'X', 'B', 'L'};
+
+    /// Fills in everything but the image size; false if the source file can't be stat'ed
+    bool sourceHeader(const std::string& path, BlobHeader& header) {
+        std::error_code error;
+        uintmax_t size = fs::file_size(path, error);
+        if (error) {
+            return false;
+        }
+        fs::file_time_type modified = fs::last_write_time(path, error);
+        if (error) {
+            return false;
+        }
+        std::memcpy(header.magic, BLOB_MAGIC, sizeof(BLOB_MAGIC));
+        header.version = TEXTURE_BLOB_VERSION;
+        header.sourceSize = size;
+        header.sourceModified = (int64_t) modified.time_since_epoch().count();
+        header.pathLength = (uint32_t) path.size();
+        header.padding = 0;
+        return true;
+    }
+
+    fs::path blobPath(const std::string& path) {
+        // the full source path is stored in the blob too, so a hash collision is detected when loading
+        return fs::path(TEXTURE_BLOB_CACHE_DIR) / (std::to_string(std::hash<std::string>()(path)) + ".rgba");
+    }
+
+    /// Whether a blob starting with `header` and `storedPath` holds the current version of the source at `path`
+    bool matches(const BlobHeader& header, const BlobHeader& expected, const char* storedPath, const std::string& path) {
+        return std::memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0
+               && header.version == expected.version
+               && header.sourceSize == expected.sourceSize
+               && header.sourceModified == expected.sourceModified
+               && header.pathLength == expected.pathLength
+               && std::memcmp(storedPath, path.data(), path.size()) == 0;
+    }
+}
+
+std::unique_ptr<Image> loadTextureBlob(const std::string& path) {
+    BlobHeader expected{};
+    if (!sourceHeader(path, expected)) {
+        return nullptr;
+    }
+    std::string file = blobPath(path).string();
+
+#ifdef _WIN32
+    std::ifstream in(file, std::ios::binary);
+    BlobHeader header{};
+    std::string storedPath(path.size(), '\0');
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || !in.read(storedPath.data(), (std::streamsize) storedPath.size())
+        || !matches(header, expected, storedPath.data(), path)) {
+        return nullptr;
+    }
+    size_t pixelBytes = (size_t) header.width * header.height * sizeof(RGBA);
+    // allocated like stb_image does, so the default ImagePixelDeleter frees it
+    auto* pixels = (RGBA*) std::malloc(pixelBytes);
+    if (!pixels || !in.read(reinterpret_cast<char*>(pixels), (std::streamsize) pixelBytes)) {
+        std::free(pixels);
+        return nullptr;
+    }
+    auto image = std::make_unique<Image>();
+    image->data = std::unique_ptr<RGBA[], ImagePixelDeleter>(pixels);
+#else
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(BlobHeader) + path.size()) {
+        close(fd);
+        return nullptr;
+    }
+    auto mappingBytes = (size_t) info.st_size;
+    // private and writable so the image can't change the file, but nothing is copied unless a page is written to
+    void* mapping = mmap(nullptr, mappingBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after the file is closed
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    BlobHeader header{};
+    std::memcpy(&header, mapping, sizeof(header));
+    size_t pixelsOffset = sizeof(BlobHeader) + path.size();
+    const char* storedPath = (const char*) mapping + sizeof(BlobHeader);
+    if (!matches(header, expected, storedPath, path)
+        || mappingBytes != pixelsOffset + (size_t) header.width * header.height * sizeof(RGBA)) {
+        munmap(mapping, mappingBytes);
+        return nullptr;
+    }
+    auto image = std::make_unique<Image>();
+    image->data = std::unique_ptr<RGBA[], ImagePixelDeleter>(
+            reinterpret_cast<RGBA*>((char*) mapping + pixelsOffset), ImagePixelDeleter{mapping, mappingBytes});
+#endif
+    image->width = (int) header.width;
+    image->height = (int) header.height;
+    return image;
+}
+
+void storeTextureBlob(const std::string& path, const Image& image) {
+    BlobHeader header{};
+    if (!sourceHeader(path, header)) {
+        return;
+    }
+    header.width = (uint32_t) image.width;
+    header.height = (uint32_t) image.height;
+
+    std::error_code error;
+    fs::create_directories(TEXTURE_BLOB_CACHE_DIR, error);
+    if (error) {
+        return;
+    }
+    // write to a temporary file and rename it into place, so a blob is never seen half written
+    fs::path target = blobPath(path);
+    fs::path temporary = target;
+    temporary += ".tmp" + std::to_string(std::hash<const void*>()(&image));
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(path.data(), (std::streamsize) path.size());
+        out.write(reinterpret_cast<const char*>(image.data.get()), (std::streamsize) (image.pixelCount() * sizeof(RGBA)));
+        if (!out) {
+            out.close();
+            fs::remove(temporary, error);
+            return;
+        }
+    }
+    fs::rename(temporary, target, error);
+    if (error) {
+        fs::remove(temporary, error);
+    }
+}
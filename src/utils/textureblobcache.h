@@ -0,0 +1,21 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "utils/imagereader.h"
+
+/// Directory (relative to the working directory, like the scene files) holding the decoded texture blobs
+#define TEXTURE_BLOB_CACHE_DIR ".texturecache"
+/// Bump whenever the blob layout changes so old blobs are ignored
+#define TEXTURE_BLOB_VERSION 1
+
+// On-disk cache of decoded RGBA images, so launching the game doesn't have to decode every JPEG/PNG again.
+// Each source image gets one blob file, valid while the source's path, size and modification time are unchanged.
+// Blobs are memory mapped on POSIX systems, so the pixels are paged in straight from the file; on Windows they're
+// read into memory instead
+
+/// Returns the cached image for the source file at `path`, or nullptr if there's no valid blob for it
+std::unique_ptr<Image> loadTextureBlob(const std::string& path);
+/// Writes `image` (decoded from the source file at `path`) to the cache. Failures are ignored, since the cache is only
+/// an optimization
+void storeTextureBlob(const std::string& path, const Image& image);
@@ -0,0 +1,40 @@
+#include <iterator>
+#include "uniformlocations.h"
+
+namespace {
+    // indexed by Uniform
+    const char* const UNIFORM_NAMES[] = {
+        "view",
+        "proj",
+        "model",
+        "inverseTransposeModel",
+        "cameraPosWS",
+        "ka",
+        "kd",
+        "ks",
+        "usesTexture",
+        "isSkybox",
+        "materialAmbient",
+        "materialDiffuse",
+        "materialSpecular",
+        "materialShininess",
+        "materialBlend",
+        "materialRepeatU",
+        "materialRepeatV",
+    };
+    static_assert(std::size(UNIFORM_NAMES) == (size_t) Uniform::COUNT, "every Uniform needs a name");
+}
+
+UniformLocations::UniformLocations() {
+    m_locations.fill(-1);
+}
+
+UniformLocations::UniformLocations(GLuint program) {
+    for (size_t i = 0; i < m_locations.size(); i++) {
+        m_locations[i] = glGetUniformLocation(program, UNIFORM_NAMES[i]);
+    }
+}
+
+GLint UniformLocations::operator[](Uniform uniform) const {
+    return m_locations[(size_t) uniform];
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <GL/glew.h>
+
+/// Uniforms used by the object shaders (default.vert/default_instanced.vert + default.frag)
+enum class Uniform {
+    VIEW,
+    PROJ,
+    MODEL,
+    INVERSE_TRANSPOSE_MODEL,
+    CAMERA_POS_WS,
+    KA,
+    KD,
+    KS,
+    USES_TEXTURE,
+    IS_SKYBOX,
+    MATERIAL_AMBIENT,
+    MATERIAL_DIFFUSE,
+    MATERIAL_SPECULAR,
+    MATERIAL_SHININESS,
+    MATERIAL_BLEND,
+    MATERIAL_REPEAT_U,
+    MATERIAL_REPEAT_V,
+    COUNT
+};
+
+/// Locations of every Uniform in one shader program, looked up once instead of with glGetUniformLocation per use.
+/// Uniforms the program doesn't have (e.g. `model` in the instanced shader) get location -1, which glUniform* ignores
+class UniformLocations {
+public:
+    UniformLocations();
+    explicit UniformLocations(GLuint program);
+
+    GLint operator[](Uniform uniform) const;
+
+private:
+    std::array<GLint, (size_t) Uniform::COUNT> m_locations;
+};